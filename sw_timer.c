@@ -1,69 +1,215 @@
 #include <assert.h>
+#include <string.h>
 
 #include "sw_timer.h"
+#include "sw_timer_engine.h"
 
 /**
- * @brief Software timer type.
+ * @brief Software timer private members type.
  *
  */
-typedef struct SW_TIMER
+typedef struct PRIVATE_MEMBERS
 {
-	// A timer relative time
-	uint32_t time;
+	set_physical_sw_timer_func_t set_physical_timer;
+	get_physical_sw_timer_counter_func_t get_physical_sw_timer_counter;
+	sw_timer_wait_func_t wait;
+	sw_timer_wake_func_t wake;
+	volatile uint32_t group_wakeups;
+	uint32_t programmed;
+	uint32_t ticking;
+	uint32_t requests;
+	uint32_t window_start;
+	uint64_t epoch_time;
+	sw_timer_stats_t stats;
+} sw_timer_private_members_t;
 
-	// A timer period
-	uint32_t period;
+sw_timer_private_members_t private_members = { NULL, NULL, NULL, NULL, 0, 0, 0, 0, 0, 0, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } };
+sw_timer_private_members_t *this = &private_members;
+
+uint32_t sw_timer_epoch = 0;
+
+#ifndef SW_TIMER_BARRIER
+#error "Blocking waits need C11 atomics, GCC builtins or SW_TIMER_BARRIER defined for memory barriers"
+#endif
 
-	// A timer mode of operations
-	uint32_t mode;
+#if SW_TIMER_BATCH_CALLBACKS > 0
 
-	// A pointer to the callback function
+/**
+ * @brief Batch callback registration type.
+ */
+typedef struct SW_TIMER_BATCH
+{
+	// A callback function timers are created with
 	sw_timer_func_ptr_t callback;
 
-	// A pointer to the callback argument
-	sw_timer_arg_ptr_t arg;
+	// A batch callback, NULL for free registration
+	sw_timer_batch_func_t batch;
+} sw_timer_batch_t;
 
-	// A pointer to the next node
-	struct SW_TIMER *next;
+/**
+ * @brief Registered batch callbacks.
+ */
+static sw_timer_batch_t batches[SW_TIMER_BATCH_CALLBACKS];
 
-	// A pointer to the previous node
-	struct SW_TIMER *prev;
-} sw_timer_t;
+/**
+ * @brief Registration of collected arguments, NULL if there are none.
+ */
+static sw_timer_batch_t *batch_pending = NULL;
 
 /**
- * @brief Software timer private members type.
+ * @brief Collected arguments.
+ */
+static sw_timer_arg_ptr_t batch_args[SW_TIMER_BATCH_SIZE];
+
+/**
+ * @brief Number of collected arguments.
+ */
+static uint32_t batch_count = 0;
+
+/**
+ * @brief Collects argument of expired timer if its callback has batch
+ * callback, delivers already collected arguments of other callback first.
  *
+ * @param callback The callback function of expired timer.
+ *
+ * @param arg The callback argument of expired timer.
+ *
+ * @return Non-zero value if the argument is collected.
  */
-typedef struct PRIVATE_MEMBERS
-{
-	sw_timer_t *head;
-	set_physical_sw_timer_func_t set_physical_timer;
-	get_physical_sw_timer_counter_func_t get_physical_sw_timer_counter;
-} sw_timer_private_members_t;
+static int sw_timer_batch_add(sw_timer_func_ptr_t callback, sw_timer_arg_ptr_t arg);
 
-sw_timer_private_members_t private_members = { NULL, NULL, NULL };
-sw_timer_private_members_t *this = &private_members;
+/**
+ * @brief Delivers collected arguments.
+ */
+static void sw_timer_batch_flush(void);
+
+#endif /* SW_TIMER_BATCH_CALLBACKS > 0 */
+
+#if SW_TIMER_RING_SIZE > 0
+
+#if (SW_TIMER_RING_SIZE & (SW_TIMER_RING_SIZE - 1)) != 0
+#error "SW_TIMER_RING_SIZE must be power of two"
+#endif
+
+#ifndef SW_TIMER_BARRIER
+#error "Expiry ring needs C11 atomics or GCC builtins for memory barriers"
+#endif
+
+/**
+ * @brief Expiry ring records.
+ */
+static sw_timer_expiry_t ring[SW_TIMER_RING_SIZE];
 
 /**
- * @brief Update relative time.
+ * @brief Number of pushed records, written only by the interrupt handler.
+ */
+static volatile uint32_t ring_pushed = 0;
+
+/**
+ * @brief Number of popped records, written only by sw_timer_ring_pop().
+ */
+static volatile uint32_t ring_popped = 0;
+
+/**
+ * @brief Pushes expiry record to the ring or counts it dropped.
+ *
+ * @param timer The pointer to expired timer.
+ *
+ * @param arg The callback argument of expired timer.
+ *
+ * @param deadline The expiry time.
+ *
+ * @param time The time the expiry is handled at.
+ */
+static void sw_timer_ring_push(sw_timer_t *timer, sw_timer_arg_ptr_t arg, uint32_t deadline, uint32_t time);
+
+#endif /* SW_TIMER_RING_SIZE > 0 */
+
+/**
+ * @brief Wakes threads waiting for the timer by sw_timer_wait() or
+ * sw_timer_wait_any().
+ *
+ * @param timer The pointer to timer that expired or was stopped.
+ *
+ * @return Non-zero value if group waiters need be woken.
+ */
+static uint32_t sw_timer_wake_waiters(sw_timer_t *timer);
+
+/**
+ * @brief Sets timer expiry time.
  *
- * If relative time should be greater or equal to 0x80000000, than need
- * reset relative time for all timers.
+ * If expiry time relative to the epoch should be greater or equal to
+ * 0x80000000, than the epoch is moved to the current time. Expiry times are
+ * not changed, so moving the epoch costs O(1) for all engines except ones
+ * that keep relative time in their own structures.
  *
  * @param timer The pointer to timer than need be updated.
  *
- * @param delta The time than need add to relative time.
+ * @param now The current time.
+ *
+ * @param delay The time from now to the timer expiry.
+ */
+static void sw_timer_set_time(sw_timer_t* timer, uint32_t now, uint32_t delay);
+
+/**
+ * @brief Moves the epoch forward and informs engine, the time the epoch
+ * was moved by is counted in 64 bits, so it does not wrap.
+ *
+ * @param epoch The new epoch.
+ */
+static void sw_timer_move_epoch(uint32_t epoch);
+
+/**
+ * @brief Starts stopped timer.
+ *
+ * @param timer The pointer to stopped timer.
+ *
+ * @param delay The time from now to the timer expiry.
+ *
+ * @return The timer status code.
+ */
+static sw_timer_status_t sw_timer_start_after(sw_timer_t *timer, uint32_t delay);
+
+/**
+ * @brief Programs physical timer for the earliest timer or stops it if there
+ * are no timers. In the tick mode the physical timer keeps ticking and only
+ * the request is counted.
+ *
+ * @param now The current time.
+ */
+static void sw_timer_program(uint32_t now);
+
+#if SW_TIMER_TICK_PERIOD > 0
+
+/**
+ * @brief Accounts time spent in the current mode and switches between the
+ * tick and tickless modes at the end of every window.
+ *
+ * The tick mode is entered when the physical timer was programmed at least
+ * SW_TIMER_TICK_ENTER times during the window, and left when it would have
+ * been programmed less than SW_TIMER_TICK_LEAVE times.
+ *
+ * @param now The current time, all timers up to it are handled in the tick
+ * mode.
  */
-static void sw_timer_update_relative_time(sw_timer_t* timer, uint32_t delta);
+static void sw_timer_tick_evaluate(uint32_t now);
+
+#endif /* SW_TIMER_TICK_PERIOD > 0 */
 
 /**
- * @brief Insert timer to doubly linked list function.
+ * @brief Returns the first delay of aligned repeating timer.
  *
- * @param timer The pointer to doubly linked list.
+ * The expiry is moved later to a multiple of the period, so timers of equal
+ * and harmonic periods expire together, or if it is too far, to a multiple
+ * of SW_TIMER_ALIGN_GRANULARITY. It is not moved by more than
+ * SW_TIMER_ALIGN_MAX_SHIFT. Multiples are counted in the 64-bit time of the
+ * epoch, so the grid does not jump when the 32-bit time wraps.
  *
- * @param new_timer The pointer to the new node that need insert in linked list.
+ * @param period The timer period.
+ *
+ * @return The delay.
  */
-static void sw_timer_insert(sw_timer_t* timer, sw_timer_t* new_timer);
+static uint32_t sw_timer_aligned_delay(uint32_t period);
 
 void sw_timer_register_physical_sw_timer_callbacks(
 		set_physical_sw_timer_func_t set_physical_timer,
@@ -73,6 +219,12 @@ void sw_timer_register_physical_sw_timer_callbacks(
 	this->get_physical_sw_timer_counter = get_physical_sw_timer_counter;
 }
 
+void sw_timer_register_wait_callbacks(sw_timer_wait_func_t wait, sw_timer_wake_func_t wake)
+{
+	this->wait = wait;
+	this->wake = wake;
+}
+
 sw_timer_handle_t sw_timer_create(
 		uint32_t period,
 		sw_timer_mode_t mode,
@@ -87,16 +239,33 @@ sw_timer_handle_t sw_timer_create(
 	timer->time = 0;
 	timer->period = period;
 	timer->mode = (uint32_t) mode;
+	timer->flags = 0;
+	timer->expiries = 0;
+	timer->waiting = 0;
+	timer->group_waiting = 0;
 
 	timer->callback = callback;
 	timer->arg = arg;
 
-	timer->next = NULL;
-	timer->prev = NULL;
+	memset(&timer->node, 0, sizeof(timer->node));
 
 	return timer;
 }
 
+sw_timer_handle_t sw_timer_create_ex(
+		uint32_t period,
+		sw_timer_mode_t mode,
+		sw_timer_func_ptr_t callback,
+		sw_timer_buffer_ex_t *buffer)
+{
+	return sw_timer_create(period, mode, callback, buffer->payload.bytes, &buffer->Dummy1);
+}
+
+void *sw_timer_payload(sw_timer_handle_t timer)
+{
+	return ((sw_timer_buffer_ex_t *) timer)->payload.bytes;
+}
+
 sw_timer_status_t sw_timer_update(
 		sw_timer_handle_t timer,
 		uint32_t period,
@@ -107,22 +276,71 @@ sw_timer_status_t sw_timer_update(
 	sw_timer_status_t status = SW_TIMER_STATUS_OK;
 
 	if ((sw_timer_t *) timer != NULL) {
-		if (((sw_timer_t *) timer)->time == 0) {
-			((sw_timer_t *) timer)->period = period;
-			((sw_timer_t *) timer)->mode = (uint32_t) mode;
+		((sw_timer_t *) timer)->period = period;
+		((sw_timer_t *) timer)->mode = (uint32_t) mode;
 
-			((sw_timer_t *) timer)->callback = callback;
-			((sw_timer_t *) timer)->arg = arg;
-		} else {
+		((sw_timer_t *) timer)->callback = callback;
+		((sw_timer_t *) timer)->arg = arg;
+
+		/* Restart already started timer without unlinking it */
+		if (((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING) {
+			if (mode == SW_TIMER_MODE_REPEATING_ALIGNED)
+				status = sw_timer_reschedule(timer, sw_timer_aligned_delay(period));
+			else
+				status = sw_timer_reschedule(timer, period);
+		}
+	} else {
+		status = SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+	}
+
+	return status;
+}
+
+sw_timer_status_t sw_timer_start(sw_timer_handle_t timer)
+{
+	sw_timer_status_t status = SW_TIMER_STATUS_OK;
+
+	if ((sw_timer_t *) timer != NULL) {
+		/* Restart already started timer */
+		if (((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING)
 			sw_timer_stop(timer);
 
-			((sw_timer_t *) timer)->period = period;
-			((sw_timer_t *) timer)->mode = (uint32_t) mode;
+		if (((sw_timer_t *) timer)->mode == SW_TIMER_MODE_REPEATING_ALIGNED)
+			status = sw_timer_start_after((sw_timer_t *) timer, sw_timer_aligned_delay(((sw_timer_t *) timer)->period));
+		else
+			status = sw_timer_start_after((sw_timer_t *) timer, ((sw_timer_t *) timer)->period);
+	} else {
+		status = SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+	}
+
+	return status;
+}
+
+sw_timer_status_t sw_timer_reschedule(sw_timer_handle_t timer, uint32_t delay)
+{
+	sw_timer_status_t status = SW_TIMER_STATUS_OK;
+
+	/* Programming the physical timer for 0 ticks stops it */
+	if (delay == 0)
+		delay = 1;
+
+	if ((sw_timer_t *) timer != NULL) {
+		if ((((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING) == 0) {
+			status = sw_timer_start_after((sw_timer_t *) timer, delay);
+		} else if ((this->set_physical_timer != NULL) && (this->get_physical_sw_timer_counter != NULL)) {
+			sw_timer_t *head = sw_timer_engine_peek();
+			uint32_t now = this->programmed - this->get_physical_sw_timer_counter();
+
+			sw_timer_set_time((sw_timer_t *) timer, now, delay);
 
-			((sw_timer_t *) timer)->callback = callback;
-			((sw_timer_t *) timer)->arg = arg;
+			/* The timer stays linked, the engine moves it from its current position */
+			sw_timer_engine_move((sw_timer_t *) timer);
 
-			sw_timer_start(timer);
+			/* Restart physical timer */
+			if ((head == (sw_timer_t *) timer) || (sw_timer_engine_peek() == (sw_timer_t *) timer))
+				sw_timer_program(now);
+		} else {
+			status = SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED;
 		}
 	} else {
 		status = SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
@@ -131,44 +349,27 @@ sw_timer_status_t sw_timer_update(
 	return status;
 }
 
-sw_timer_status_t sw_timer_start(sw_timer_handle_t timer)
+sw_timer_status_t sw_timer_arm_if_earlier(sw_timer_handle_t timer, uint32_t delay)
 {
 	sw_timer_status_t status = SW_TIMER_STATUS_OK;
 
-	if ((sw_timer_t *) timer != NULL) {
-		if (this->head == NULL) {
-			this->head = (sw_timer_t *) timer;
+	/* Programming the physical timer for 0 ticks stops it */
+	if (delay == 0)
+		delay = 1;
 
-			this->head->time = this->head->period;
+	if ((sw_timer_t *) timer != NULL) {
+		if ((((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING) == 0) {
+			status = sw_timer_start_after((sw_timer_t *) timer, delay);
+		} else if (this->get_physical_sw_timer_counter != NULL) {
+			uint32_t now = this->programmed - this->get_physical_sw_timer_counter();
+			uint32_t remaining = ((sw_timer_t *) timer)->time - now;
 
-			/* Start physical timer */
-			if (this->set_physical_timer != NULL)
-				this->set_physical_timer(this->head->period);
-			else
-				status = SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED;
+			/* Nothing is changed if the timer already expires not later, in
+			 * the tick mode the timer can be already due */
+			if (((int32_t) remaining > 0) && (delay < remaining))
+				status = sw_timer_reschedule(timer, delay);
 		} else {
-			if ((this->set_physical_timer != NULL) && (this->get_physical_sw_timer_counter != NULL)) {
-				sw_timer_update_relative_time(
-						(sw_timer_t *) timer,
-						this->head->time
-						- this->get_physical_sw_timer_counter()
-						+ ((sw_timer_t *) timer)->period);
-
-				if (((sw_timer_t *) timer)->time < this->head->time) {
-					/* Restart physical timer */
-					this->set_physical_timer(
-							((sw_timer_t *) timer)->time
-							- (this->head->time - this->get_physical_sw_timer_counter()));
-
-					((sw_timer_t *) timer)->next = this->head;
-					this->head->prev = ((sw_timer_t *) timer);
-					this->head = ((sw_timer_t *) timer);
-				} else {
-					sw_timer_insert(this->head->next, ((sw_timer_t *) timer));
-				}
-			} else {
-				status = SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED;
-			}
+			status = SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED;
 		}
 	} else {
 		status = SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
@@ -177,43 +378,53 @@ sw_timer_status_t sw_timer_start(sw_timer_handle_t timer)
 	return status;
 }
 
+sw_timer_status_t sw_timer_arm_if_not_running(sw_timer_handle_t timer, uint32_t delay)
+{
+	sw_timer_status_t status = SW_TIMER_STATUS_OK;
+
+	/* Programming the physical timer for 0 ticks stops it */
+	if (delay == 0)
+		delay = 1;
+
+	if ((sw_timer_t *) timer != NULL) {
+		if ((((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING) == 0)
+			status = sw_timer_start_after((sw_timer_t *) timer, delay);
+	} else {
+		status = SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+	}
+
+	return status;
+}
+
 sw_timer_status_t sw_timer_stop(sw_timer_handle_t timer)
 {
 	sw_timer_status_t status = SW_TIMER_STATUS_OK;
 
 	if ((sw_timer_t *) timer != NULL) {
-		if (this->head) {
-			if (this->head == (sw_timer_t *) timer) {
-				if (this->head->next != NULL) {
-					/* restart physical timer */
-					this->set_physical_timer(
-							this->head->next->time
-							- (this->head->time - this->get_physical_sw_timer_counter()));
-
-					this->head = this->head->next;
-					this->head->prev = NULL;
-
-					((sw_timer_t *) timer)->time = 0;
-					((sw_timer_t *) timer)->next = NULL;
-				} else {
-					this->head->time = 0;
-					this->head = NULL;
-
-					/* Stop physical timer */
-					this->set_physical_timer(0);
-				}
-			} else {
-				((sw_timer_t *) timer)->time = 0;
-
-				if (((sw_timer_t *) timer)->next != NULL) {
-					((sw_timer_t *) timer)->next->prev = ((sw_timer_t *) timer)->prev;
-					((sw_timer_t *) timer)->prev->next = ((sw_timer_t *) timer)->next;
-					((sw_timer_t *) timer)->prev = NULL;
-					((sw_timer_t *) timer)->next = NULL;
-				} else {
-					((sw_timer_t *) timer)->prev->next = NULL;
-					((sw_timer_t *) timer)->prev = NULL;
-				}
+		if (((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING) {
+			sw_timer_t *head = sw_timer_engine_peek();
+
+			sw_timer_engine_remove((sw_timer_t *) timer);
+
+			this->stats.cancelled++;
+
+			/* Restart or stop physical timer */
+			if (head == (sw_timer_t *) timer) {
+				uint32_t now = this->programmed - this->get_physical_sw_timer_counter();
+
+				/* Time stands still at the stop while no timers are running */
+				if (sw_timer_engine_peek() == NULL)
+					sw_timer_move_epoch(now);
+
+				sw_timer_program(now);
+			}
+
+			((sw_timer_t *) timer)->flags &= ~SW_TIMER_FLAG_RUNNING;
+
+			/* Waiters of the stopped timer return an error */
+			if (sw_timer_wake_waiters((sw_timer_t *) timer)) {
+				this->group_wakeups++;
+				this->wake(&this->group_wakeups);
 			}
 		}
 	} else {
@@ -223,94 +434,591 @@ sw_timer_status_t sw_timer_stop(sw_timer_handle_t timer)
 	return status;
 }
 
-void sw_timer_interrupt_handler()
+uint32_t sw_timer_now(void)
 {
-	uint32_t time = this->head->time;
+	/* Time stands still at the epoch while no timers are running */
+	if ((sw_timer_engine_peek() == NULL) || (this->get_physical_sw_timer_counter == NULL))
+		return sw_timer_epoch;
 
-	while (this->head && (this->head->time == time)) {
-		void (*callback)(void* arg) = this->head->callback;
-		void * arg = this->head->arg;
+	return this->programmed - this->get_physical_sw_timer_counter();
+}
 
-		if (this->head->mode == SW_TIMER_MODE_SINGLE_SHOT) {
-			this->head->time = 0;
+uint32_t sw_timer_remaining(sw_timer_handle_t timer)
+{
+	uint32_t remaining;
 
-			if (this->head->next != NULL) {
-				sw_timer_t* next_timer = this->head->next;
+	if (((sw_timer_t *) timer == NULL) || ((((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING) == 0))
+		return 0;
 
-				this->head->next = NULL;
-				this->head = next_timer;
-				this->head->prev = NULL;
-			}
-			else {
-				this->head = NULL;
-			}
-		} else if (this->head->mode == SW_TIMER_MODE_REPEATING) {
-			sw_timer_update_relative_time(this->head, this->head->period);
+	if (this->get_physical_sw_timer_counter == NULL)
+		return 0;
+
+	remaining = ((sw_timer_t *) timer)->time - (this->programmed - this->get_physical_sw_timer_counter());
+
+	/* In the tick mode the timer can be due before the next tick */
+	return ((int32_t) remaining > 0) ? remaining : 0;
+}
+
+uint32_t sw_timer_is_running(sw_timer_handle_t timer)
+{
+	if ((sw_timer_t *) timer == NULL)
+		return 0;
+
+	return ((sw_timer_t *) timer)->flags & SW_TIMER_FLAG_RUNNING;
+}
+
+uint32_t sw_timer_expiries(sw_timer_handle_t timer)
+{
+	return ((sw_timer_t *) timer)->expiries;
+}
+
+sw_timer_status_t sw_timer_wait(sw_timer_handle_t timer, uint32_t expiries)
+{
+	sw_timer_t *waited = (sw_timer_t *) timer;
+
+	if (waited == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	for (;;) {
+		/* The mark is set before the timer is checked, so the interrupt
+		 * handler either sees it and wakes the thread, or the check sees
+		 * the expiry */
+		waited->waiting = 1;
+
+		SW_TIMER_BARRIER();
+
+		if (waited->expiries != expiries)
+			return SW_TIMER_STATUS_OK;
+
+		if ((waited->flags & SW_TIMER_FLAG_RUNNING) == 0)
+			return SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING;
+
+		if (this->wait != NULL)
+			this->wait(&waited->expiries, expiries);
+	}
+}
+
+sw_timer_status_t sw_timer_wait_any(
+		const sw_timer_handle_t *timers,
+		const uint32_t *expiries,
+		uint32_t count,
+		uint32_t *index)
+{
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		if ((sw_timer_t *) timers[i] == NULL)
+			return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+	}
 
-			if ((this->head->next != NULL) && (this->head->time > this->head->next->time)) {
-				this->head = this->head->next;
+	for (;;) {
+		/* Group wakeups are read and timers are marked before timers are
+		 * checked, so an expiry after the check makes the wait return at
+		 * once */
+		uint32_t group_wakeups = this->group_wakeups;
+		uint32_t running = 0;
 
-				sw_timer_insert(this->head, this->head->prev);
+		for (i = 0; i < count; i++)
+			((sw_timer_t *) timers[i])->group_waiting = 1;
 
-				this->head->prev = NULL;
+		SW_TIMER_BARRIER();
+
+		for (i = 0; i < count; i++) {
+			if (((sw_timer_t *) timers[i])->expiries != expiries[i]) {
+				*index = i;
+
+				return SW_TIMER_STATUS_OK;
 			}
+
+			running |= ((sw_timer_t *) timers[i])->flags & SW_TIMER_FLAG_RUNNING;
+		}
+
+		if (running == 0)
+			return SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING;
+
+		if (this->wait != NULL)
+			this->wait(&this->group_wakeups, group_wakeups);
+	}
+}
+
+void sw_timer_get_stats(sw_timer_stats_t *stats)
+{
+	*stats = this->stats;
+
+	sw_timer_engine_get_stats(stats);
+}
+
+void sw_timer_interrupt_handler()
+{
+	sw_timer_t *head = sw_timer_engine_peek();
+	uint32_t group_wake = 0;
+	uint32_t time;
+
+#if SW_TIMER_TICK_PERIOD > 0
+	if (this->ticking) {
+		/* The next tick is programmed before timers due up to this tick are
+		 * handled */
+		time = this->programmed;
+
+		this->programmed = time + SW_TIMER_TICK_PERIOD;
+		this->set_physical_timer(SW_TIMER_TICK_PERIOD);
+	} else
+#endif
+	{
+		if (head == NULL)
+			return;
+
+		time = head->time;
+	}
+
+	this->stats.wakeups++;
+
+	while (head && ((int32_t) (head->time - time) <= 0)) {
+		uint32_t expiry = head->time;
+		void (*callback)(void* arg) = head->callback;
+		void * arg = head->arg;
+#if SW_TIMER_RING_SIZE > 0
+		sw_timer_t *expired = head;
+		uint32_t ring = head->flags & SW_TIMER_FLAG_RING;
+#endif
+#if SW_TIMER_BATCH_CALLBACKS > 0
+		sw_timer_func_ptr_t expired_callback = head->callback;
+#endif
+
+		this->stats.expired++;
+
+		head->expiries++;
+
+		group_wake |= sw_timer_wake_waiters(head);
+
+		if (head->mode == SW_TIMER_MODE_SINGLE_SHOT) {
+			sw_timer_engine_expire(head);
+
+			head->flags &= ~SW_TIMER_FLAG_RUNNING;
+		} else if ((head->mode == SW_TIMER_MODE_REPEATING) || (head->mode == SW_TIMER_MODE_REPEATING_ALIGNED)) {
+			sw_timer_set_time(head, expiry, head->period);
+
+			sw_timer_engine_expire(head);
+			sw_timer_engine_insert(head);
 		} else {
 			assert(0);
 		}
 
-		if (this->head)
+		head = sw_timer_engine_peek();
+
+		if (head)
 		{
 			/* Start physical timer for the next shortest time */
-			if (this->head->time != time)
-				this->set_physical_timer(this->head->time - time);
+			if (head->time != time)
+				sw_timer_program(time);
 		} else {
+			/* Time stands still at the expiry while no timers are running, so
+			 * timers started by the callback cannot expire in this loop */
+			sw_timer_move_epoch(time);
+
 			/* Stop physical timer */
-			this->set_physical_timer(0);
+			sw_timer_program(time);
+		}
+
+#if SW_TIMER_RING_SIZE > 0
+		/* Expiries of ring timers go to the ring instead of callbacks */
+		if (ring) {
+			sw_timer_ring_push(expired, arg, expiry, time);
+
+			head = sw_timer_engine_peek();
+
+			continue;
+		}
+#endif
+
+#if SW_TIMER_BATCH_CALLBACKS > 0
+		/* Collect argument for batch callback */
+		if (sw_timer_batch_add(expired_callback, arg)) {
+			head = sw_timer_engine_peek();
+
+			continue;
 		}
+#endif
 
 		/* Run callback function if exists with argument */
 		if (callback != NULL)
 			callback(arg);
+
+		head = sw_timer_engine_peek();
+	}
+
+#if SW_TIMER_BATCH_CALLBACKS > 0
+	sw_timer_batch_flush();
+#endif
+
+#if SW_TIMER_TICK_PERIOD > 0
+	if (this->ticking)
+		sw_timer_tick_evaluate(time);
+#endif
+
+	/* Wake group waiters once per interrupt */
+	if (group_wake) {
+		this->group_wakeups++;
+		this->wake(&this->group_wakeups);
 	}
 }
 
-static void sw_timer_update_relative_time(sw_timer_t* timer, uint32_t delta)
+#if SW_TIMER_BATCH_CALLBACKS > 0
+
+sw_timer_status_t sw_timer_register_batch_callback(sw_timer_func_ptr_t callback, sw_timer_batch_func_t batch)
 {
-	if (((timer->time + delta) && 0x80000000) != 0) {
-		sw_timer_t* _timer = this->head;
+	sw_timer_batch_t *free_entry = NULL;
+	uint32_t i;
 
-		uint32_t shift_time = _timer->time - this->get_physical_sw_timer_counter();
+	for (i = 0; i < SW_TIMER_BATCH_CALLBACKS; i++) {
+		if ((batches[i].batch != NULL) && (batches[i].callback == callback)) {
+			batches[i].batch = batch;
 
-		while (_timer) {
-			_timer->time -= shift_time;
+			return SW_TIMER_STATUS_OK;
+		}
 
-			_timer = _timer->next;
+		if ((batches[i].batch == NULL) && (free_entry == NULL))
+			free_entry = &batches[i];
+	}
+
+	if (batch == NULL)
+		return SW_TIMER_STATUS_OK;
+
+	if (free_entry == NULL)
+		return SW_TIMER_STATUS_ERROR_BATCH_CALLBACKS_FULL;
+
+	free_entry->callback = callback;
+	free_entry->batch = batch;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+static int sw_timer_batch_add(sw_timer_func_ptr_t callback, sw_timer_arg_ptr_t arg)
+{
+	uint32_t i;
+
+	if ((batch_pending != NULL) && (batch_pending->callback == callback)) {
+		batch_args[batch_count++] = arg;
+	} else {
+		sw_timer_batch_flush();
+
+		for (i = 0; i < SW_TIMER_BATCH_CALLBACKS; i++) {
+			if ((batches[i].batch != NULL) && (batches[i].callback == callback))
+				break;
 		}
+
+		if (i == SW_TIMER_BATCH_CALLBACKS)
+			return 0;
+
+		batch_pending = &batches[i];
+		batch_args[batch_count++] = arg;
 	}
 
-	timer->time += delta;
+	if (batch_count == SW_TIMER_BATCH_SIZE)
+		sw_timer_batch_flush();
+
+	return 1;
+}
+
+static void sw_timer_batch_flush(void)
+{
+	sw_timer_batch_t *pending = batch_pending;
+	uint32_t count = batch_count;
+
+	if (pending == NULL)
+		return;
+
+	batch_pending = NULL;
+	batch_count = 0;
+
+	/* The batch callback could be unregistered by an earlier callback */
+	if (pending->batch != NULL)
+		pending->batch(batch_args, count);
+}
+
+#else
+
+sw_timer_status_t sw_timer_register_batch_callback(sw_timer_func_ptr_t callback, sw_timer_batch_func_t batch)
+{
+	(void) callback;
+	(void) batch;
+
+	return SW_TIMER_STATUS_ERROR_BATCH_CALLBACKS_FULL;
+}
+
+#endif /* SW_TIMER_BATCH_CALLBACKS > 0 */
+
+#if SW_TIMER_RING_SIZE > 0
+
+sw_timer_status_t sw_timer_ring_delivery(sw_timer_handle_t timer, uint32_t enable)
+{
+	if ((sw_timer_t *) timer == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (enable)
+		((sw_timer_t *) timer)->flags |= SW_TIMER_FLAG_RING;
+	else
+		((sw_timer_t *) timer)->flags &= ~SW_TIMER_FLAG_RING;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+uint32_t sw_timer_ring_pop(sw_timer_expiry_t *records, uint32_t max)
+{
+	uint32_t popped = ring_popped;
+	uint32_t count = ring_pushed - popped;
+	uint32_t i;
+
+	if (count > max)
+		count = max;
+
+	/* Records are read after the pushed counter */
+	SW_TIMER_BARRIER();
+
+	for (i = 0; i < count; i++)
+		records[i] = ring[(popped + i) & (SW_TIMER_RING_SIZE - 1)];
+
+	/* Records are read before they are given back to the producer */
+	SW_TIMER_BARRIER();
+
+	ring_popped = popped + count;
+
+	return count;
 }
 
-static void sw_timer_insert(sw_timer_t* timer, sw_timer_t* new_timer)
+static void sw_timer_ring_push(sw_timer_t *timer, sw_timer_arg_ptr_t arg, uint32_t deadline, uint32_t time)
 {
-	while (timer) {
-		if (new_timer->time < timer->time) {
-			new_timer->next = timer;
-			new_timer->prev = timer->prev;
-			timer->prev->next = new_timer;
-			timer->prev = new_timer;
+	uint32_t pushed = ring_pushed;
+	uint32_t used = pushed - ring_popped;
+	sw_timer_expiry_t *record;
+
+	if (used >= SW_TIMER_RING_SIZE) {
+		this->stats.ring_dropped++;
+
+		return;
+	}
 
-			break;
+	if (used + 1 > this->stats.ring_max_used)
+		this->stats.ring_max_used = used + 1;
+
+	record = &ring[pushed & (SW_TIMER_RING_SIZE - 1)];
+	record->timer = timer;
+	record->arg = arg;
+	record->deadline = deadline;
+	record->time = time;
+
+	/* The record is written before it is published */
+	SW_TIMER_BARRIER();
+
+	ring_pushed = pushed + 1;
+}
+
+#else
+
+sw_timer_status_t sw_timer_ring_delivery(sw_timer_handle_t timer, uint32_t enable)
+{
+	(void) enable;
+
+	return ((sw_timer_t *) timer == NULL) ? SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST : SW_TIMER_STATUS_ERROR_RING_DISABLED;
+}
+
+uint32_t sw_timer_ring_pop(sw_timer_expiry_t *records, uint32_t max)
+{
+	(void) records;
+	(void) max;
+
+	return 0;
+}
+
+#endif /* SW_TIMER_RING_SIZE > 0 */
+
+static uint32_t sw_timer_wake_waiters(sw_timer_t *timer)
+{
+	uint32_t group_wake = 0;
+
+	if (this->wake == NULL)
+		return 0;
+
+	/* The expiry or the stop is visible before the marks are read */
+	SW_TIMER_BARRIER();
+
+	if (timer->waiting) {
+		timer->waiting = 0;
+
+		this->wake(&timer->expiries);
+	}
+
+	if (timer->group_waiting) {
+		timer->group_waiting = 0;
+
+		group_wake = 1;
+	}
+
+	return group_wake;
+}
+
+static void sw_timer_set_time(sw_timer_t* timer, uint32_t now, uint32_t delay)
+{
+	/* In the tick mode timers can be due up to one tick before now */
+	uint32_t epoch = now - SW_TIMER_TICK_PERIOD;
+
+	if (((epoch - sw_timer_epoch + SW_TIMER_TICK_PERIOD + delay) & 0x80000000) != 0)
+		sw_timer_move_epoch(epoch);
+
+	timer->time = now + delay;
+}
+
+static void sw_timer_move_epoch(uint32_t epoch)
+{
+	uint32_t shift_time = epoch - sw_timer_epoch;
+
+	/* Engines find keys of running timers from the new epoch */
+	sw_timer_epoch = epoch;
+	this->epoch_time += shift_time;
+
+	sw_timer_engine_shift(shift_time);
+}
+
+static uint32_t sw_timer_aligned_delay(uint32_t period)
+{
+	sw_timer_t *head = sw_timer_engine_peek();
+	uint32_t now = sw_timer_epoch;
+	uint64_t time;
+	uint32_t shift = 0;
+
+	if ((head != NULL) && (this->get_physical_sw_timer_counter != NULL))
+		now = this->programmed - this->get_physical_sw_timer_counter();
+
+	time = this->epoch_time + (now - sw_timer_epoch) + period;
+
+	if (period != 0)
+		shift = (uint32_t) ((period - (time % period)) % period);
+
+	if ((shift > SW_TIMER_ALIGN_MAX_SHIFT) && (SW_TIMER_ALIGN_GRANULARITY != 0))
+		shift = (uint32_t) ((SW_TIMER_ALIGN_GRANULARITY - (time % SW_TIMER_ALIGN_GRANULARITY)) % SW_TIMER_ALIGN_GRANULARITY);
+
+	if (shift > SW_TIMER_ALIGN_MAX_SHIFT)
+		return period;
+
+	if (shift != 0)
+		this->stats.aligned++;
+
+	return period + shift;
+}
+
+static sw_timer_status_t sw_timer_start_after(sw_timer_t *timer, uint32_t delay)
+{
+	sw_timer_status_t status = SW_TIMER_STATUS_OK;
+	sw_timer_t *head = sw_timer_engine_peek();
+
+	if (head == NULL) {
+		/* Time stands still at the epoch while no timers are running */
+		sw_timer_set_time(timer, sw_timer_epoch, delay);
+
+		sw_timer_engine_insert(timer);
+
+		timer->flags |= SW_TIMER_FLAG_RUNNING;
+
+		/* Start physical timer, the tick mode window starts with it */
+		if (this->set_physical_timer != NULL) {
+			this->requests = 0;
+			this->window_start = sw_timer_epoch;
+
+			sw_timer_program(sw_timer_epoch);
+		} else {
+			status = SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED;
 		}
+	} else {
+		if ((this->set_physical_timer != NULL) && (this->get_physical_sw_timer_counter != NULL)) {
+			uint32_t now = this->programmed - this->get_physical_sw_timer_counter();
+
+			sw_timer_set_time(timer, now, delay);
+
+			sw_timer_engine_insert(timer);
+
+			timer->flags |= SW_TIMER_FLAG_RUNNING;
+
+			/* Restart physical timer */
+			if (SW_TIMER_ENGINE_KEY(timer->time) < SW_TIMER_ENGINE_KEY(head->time))
+				sw_timer_program(now);
+		} else {
+			status = SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED;
+		}
+	}
+
+	return status;
+}
 
-		if (timer->next == NULL) {
-			timer->next = new_timer;
-			new_timer->next = NULL;
-			new_timer->prev = timer;
+static void sw_timer_program(uint32_t now)
+{
+	sw_timer_t *head = sw_timer_engine_peek();
+
+	this->requests++;
+
+#if SW_TIMER_TICK_PERIOD > 0
+	if (this->ticking) {
+		/* Nothing is ticked without timers */
+		if (head == NULL) {
+			sw_timer_tick_evaluate(now);
 
-			break;
+			this->ticking = 0;
+			this->stats.tick_switches++;
+
+			this->set_physical_timer(0);
 		}
 
-		timer = timer->next;
+		return;
+	}
+#endif
+
+	if (head != NULL) {
+		this->programmed = head->time;
+		this->set_physical_timer(head->time - now);
+
+#if SW_TIMER_TICK_PERIOD > 0
+		sw_timer_tick_evaluate(now);
+#endif
+	} else {
+		this->set_physical_timer(0);
+
+#if SW_TIMER_TICK_PERIOD > 0
+		sw_timer_tick_evaluate(now);
+#endif
+	}
+}
+
+#if SW_TIMER_TICK_PERIOD > 0
+
+static void sw_timer_tick_evaluate(uint32_t now)
+{
+	sw_timer_t *head = sw_timer_engine_peek();
+	uint32_t elapsed = now - this->window_start;
+
+	if ((elapsed < SW_TIMER_TICK_PERIOD * SW_TIMER_TICK_WINDOW) && (head != NULL))
+		return;
+
+	if (this->ticking)
+		this->stats.tick_time += elapsed;
+	else
+		this->stats.tickless_time += elapsed;
+
+	if (!this->ticking && (head != NULL) && (this->requests >= SW_TIMER_TICK_ENTER)) {
+		this->ticking = 1;
+		this->stats.tick_switches++;
+
+		this->programmed = now + SW_TIMER_TICK_PERIOD;
+		this->set_physical_timer(SW_TIMER_TICK_PERIOD);
+	} else if (this->ticking && (head != NULL) && (this->requests < SW_TIMER_TICK_LEAVE)) {
+		/* Called after all timers up to now are handled */
+		this->ticking = 0;
+		this->stats.tick_switches++;
+
+		this->programmed = head->time;
+		this->set_physical_timer(head->time - now);
 	}
+
+	this->requests = 0;
+	this->window_start = now;
 }
+
+#endif /* SW_TIMER_TICK_PERIOD > 0 */
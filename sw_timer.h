@@ -17,6 +17,320 @@
 #define SW_TIMER_TICK_RATE_HZ 1000000
 #endif
 
+/**
+ * @brief SW_TIMER_ENGINE macro selects the data structure that keeps running
+ * timers ordered by expiry time and could be defined by application developer.
+ *
+ * SW_TIMER_ENGINE_LIST - sorted doubly linked list, starting a timer costs
+ * O(n). It is the default engine and the best one for a few timers.
+ *
+ * SW_TIMER_ENGINE_FIFO - one FIFO per distinct period and a small heap over
+ * the FIFO heads. Timers with the same period started in order expire in
+ * order, so starting a timer is appending to FIFO tail, which costs O(1) for
+ * up to SW_TIMER_FIFO_PERIODS distinct periods.
+ *
+ * SW_TIMER_ENGINE_RADIX - radix heap over 32-bit expiry time, timers are
+ * put to buckets by the highest bit differing from the last minimum. Expiry
+ * times are monotone, so starting a timer costs O(1) and finding the next
+ * timer costs amortized O(log C), where C is the longest period.
+ *
+ * SW_TIMER_ENGINE_HYBRID - timing wheel and heap. The engine counts how often
+ * timers of every period are stopped before expiry; timers of periods that
+ * are usually stopped are started in the wheel in O(1), timers of periods
+ * that usually expire and timers that do not fit the wheel are started in
+ * the heap. The next timer is the earlier of wheel and heap ones.
+ *
+ * SW_TIMER_ENGINE_ADAPTIVE - sorted doubly linked list while there are a few
+ * timers and heap while there are many. When starting a timer passes more
+ * than SW_TIMER_ADAPTIVE_HEAP_STEPS list nodes, the sorted list is turned to
+ * the heap in one pass, because sorted list is already a valid heap. When
+ * there are less than SW_TIMER_ADAPTIVE_LIST_COUNT running timers, the heap
+ * is turned back to the list. Timers stay running during the switch.
+ */
+#define SW_TIMER_ENGINE_LIST 0
+#define SW_TIMER_ENGINE_FIFO 1
+#define SW_TIMER_ENGINE_RADIX 2
+#define SW_TIMER_ENGINE_HYBRID 3
+#define SW_TIMER_ENGINE_ADAPTIVE 4
+
+#ifndef SW_TIMER_ENGINE
+#define SW_TIMER_ENGINE SW_TIMER_ENGINE_LIST
+#endif
+
+/**
+ * @brief SW_TIMER_FIFO_PERIODS macro define number of distinct periods that
+ * SW_TIMER_ENGINE_FIFO engine keeps in separate FIFOs.
+ *
+ * Timers of other periods are kept in one extra FIFO sorted on insertion.
+ */
+#ifndef SW_TIMER_FIFO_PERIODS
+#define SW_TIMER_FIFO_PERIODS 8
+#endif
+
+/**
+ * @brief SW_TIMER_WHEEL_SLOTS macro define number of timing wheel slots of
+ * SW_TIMER_ENGINE_HYBRID engine.
+ */
+#ifndef SW_TIMER_WHEEL_SLOTS
+#define SW_TIMER_WHEEL_SLOTS 256
+#endif
+
+/**
+ * @brief SW_TIMER_WHEEL_RESOLUTION macro define number of ticks covered by
+ * one timing wheel slot of SW_TIMER_ENGINE_HYBRID engine.
+ *
+ * Timers that expire later than (SW_TIMER_WHEEL_SLOTS - 1) slots after the
+ * earliest timer in the wheel are started in the heap.
+ */
+#ifndef SW_TIMER_WHEEL_RESOLUTION
+#define SW_TIMER_WHEEL_RESOLUTION SW_TIMER_CONV_MILLISECONDS_TO_TICKS(100)
+#endif
+
+/**
+ * @brief SW_TIMER_HYBRID_PERIODS macro define number of distinct periods
+ * SW_TIMER_ENGINE_HYBRID engine keeps cancellation history for.
+ */
+#ifndef SW_TIMER_HYBRID_PERIODS
+#define SW_TIMER_HYBRID_PERIODS 8
+#endif
+
+/**
+ * @brief SW_TIMER_ADAPTIVE_HEAP_STEPS macro define number of list nodes
+ * passed by starting a timer, from which SW_TIMER_ENGINE_ADAPTIVE engine
+ * switches to the heap.
+ */
+#ifndef SW_TIMER_ADAPTIVE_HEAP_STEPS
+#define SW_TIMER_ADAPTIVE_HEAP_STEPS 32
+#endif
+
+/**
+ * @brief SW_TIMER_ADAPTIVE_LIST_COUNT macro define number of running timers,
+ * below which SW_TIMER_ENGINE_ADAPTIVE engine switches back to the list.
+ * Must be less than SW_TIMER_ADAPTIVE_HEAP_STEPS.
+ */
+#ifndef SW_TIMER_ADAPTIVE_LIST_COUNT
+#define SW_TIMER_ADAPTIVE_LIST_COUNT 8
+#endif
+
+/**
+ * @brief SW_TIMER_POOL_SIZE macro define number of timers in the static pool
+ * used by sw_timer_pool_create(). Pool is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_POOL_SIZE
+#define SW_TIMER_POOL_SIZE 0
+#endif
+
+/**
+ * @brief SW_TIMER_KEY_SLOTS macro define number of entries of the key index
+ * used by sw_timer_key_bind(), must be power of two. One entry is always
+ * kept empty. Key index is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_KEY_SLOTS
+#define SW_TIMER_KEY_SLOTS 0
+#endif
+
+/**
+ * @brief SW_TIMER_PAYLOAD_SIZE macro define number of bytes of the inline
+ * payload of timers created by sw_timer_create_ex().
+ */
+#ifndef SW_TIMER_PAYLOAD_SIZE
+#define SW_TIMER_PAYLOAD_SIZE 16
+#endif
+
+/**
+ * @brief SW_TIMER_BATCH_CALLBACKS macro define number of callback functions
+ * that can be registered with sw_timer_register_batch_callback(). Batch
+ * delivery is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_BATCH_CALLBACKS
+#define SW_TIMER_BATCH_CALLBACKS 0
+#endif
+
+/**
+ * @brief SW_TIMER_BATCH_SIZE macro define maximum number of arguments
+ * delivered by one batch callback call.
+ */
+#ifndef SW_TIMER_BATCH_SIZE
+#define SW_TIMER_BATCH_SIZE 32
+#endif
+
+/**
+ * @brief SW_TIMER_RING_SIZE macro define number of records of the expiry
+ * ring, must be power of two. Expiry ring is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_RING_SIZE
+#define SW_TIMER_RING_SIZE 0
+#endif
+
+/**
+ * @brief SW_TIMER_TTL_BUCKETS macro define number of hash buckets of the TTL
+ * map, must be power of two. TTL map is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_TTL_BUCKETS
+#define SW_TIMER_TTL_BUCKETS 0
+#endif
+
+/**
+ * @brief SW_TIMER_TTL_SLOTS macro define number of wheel slots of the TTL
+ * map. Entries with TTL longer than one wheel turn stay in their slot for
+ * several turns.
+ */
+#ifndef SW_TIMER_TTL_SLOTS
+#define SW_TIMER_TTL_SLOTS 64
+#endif
+
+/**
+ * @brief SW_TIMER_TTL_RESOLUTION macro define number of ticks between wheel
+ * steps of the TTL map, entries are evicted up to this time late.
+ */
+#ifndef SW_TIMER_TTL_RESOLUTION
+#define SW_TIMER_TTL_RESOLUTION SW_TIMER_CONV_MILLISECONDS_TO_TICKS(1000)
+#endif
+
+/**
+ * @brief SW_TIMER_LEASE_SLOTS macro define number of wheel slots of the
+ * lease manager. Lease manager is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_LEASE_SLOTS
+#define SW_TIMER_LEASE_SLOTS 0
+#endif
+
+/**
+ * @brief SW_TIMER_LEASE_GRANULARITY macro define number of ticks of the
+ * interval whose leases are delivered by one wakeup. Renewals are delivered
+ * up to this time early and expiries up to this time late.
+ */
+#ifndef SW_TIMER_LEASE_GRANULARITY
+#define SW_TIMER_LEASE_GRANULARITY SW_TIMER_CONV_MILLISECONDS_TO_TICKS(100)
+#endif
+
+/**
+ * @brief SW_TIMER_LEASE_BATCH macro define maximum number of leases
+ * delivered by one bulk callback call.
+ */
+#ifndef SW_TIMER_LEASE_BATCH
+#define SW_TIMER_LEASE_BATCH 32
+#endif
+
+/**
+ * @brief SW_TIMER_WINDOW_CLOCKS macro define number of distinct bucket
+ * widths of sliding window counters, counters of one width share one
+ * rotation timer. Window counters are not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_WINDOW_CLOCKS
+#define SW_TIMER_WINDOW_CLOCKS 0
+#endif
+
+/**
+ * @brief SW_TIMER_WINDOW_BUCKETS macro define maximum number of buckets of
+ * one sliding window counter.
+ */
+#ifndef SW_TIMER_WINDOW_BUCKETS
+#define SW_TIMER_WINDOW_BUCKETS 60
+#endif
+
+/**
+ * @brief SW_TIMER_CYCLIC_TASKS macro define maximum number of tasks of the
+ * cyclic executive, up to 256. Cyclic executive is not compiled in if it
+ * is 0.
+ */
+#ifndef SW_TIMER_CYCLIC_TASKS
+#define SW_TIMER_CYCLIC_TASKS 0
+#endif
+
+/**
+ * @brief SW_TIMER_CYCLIC_FRAMES macro define maximum number of frames in
+ * the hyperperiod of the cyclic executive.
+ */
+#ifndef SW_TIMER_CYCLIC_FRAMES
+#define SW_TIMER_CYCLIC_FRAMES 64
+#endif
+
+/**
+ * @brief SW_TIMER_CYCLIC_ENTRIES macro define maximum number of task
+ * releases in the hyperperiod of the cyclic executive.
+ */
+#ifndef SW_TIMER_CYCLIC_ENTRIES
+#define SW_TIMER_CYCLIC_ENTRIES 256
+#endif
+
+/**
+ * @brief SW_TIMER_ALIGN_GRANULARITY macro define number of ticks of the
+ * grid SW_TIMER_MODE_REPEATING_ALIGNED timers are aligned to when aligning
+ * to their period would move them too far, 0 to align only to the period.
+ */
+#ifndef SW_TIMER_ALIGN_GRANULARITY
+#define SW_TIMER_ALIGN_GRANULARITY SW_TIMER_CONV_MILLISECONDS_TO_TICKS(10)
+#endif
+
+/**
+ * @brief SW_TIMER_ALIGN_MAX_SHIFT macro define maximum number of ticks the
+ * first expiry of SW_TIMER_MODE_REPEATING_ALIGNED timer is moved later by.
+ */
+#ifndef SW_TIMER_ALIGN_MAX_SHIFT
+#define SW_TIMER_ALIGN_MAX_SHIFT SW_TIMER_CONV_MILLISECONDS_TO_TICKS(10)
+#endif
+
+/**
+ * @brief SW_TIMER_TICK_PERIOD macro define number of ticks between periodic
+ * interrupts of the tick mode. In the tick mode the physical timer is not
+ * programmed for every new earliest timer, timers are handled up to this
+ * time late. The tick mode is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_TICK_PERIOD
+#define SW_TIMER_TICK_PERIOD 0
+#endif
+
+/**
+ * @brief SW_TIMER_TICK_WINDOW macro define number of tick periods of the
+ * window the tick and tickless modes are switched after.
+ */
+#ifndef SW_TIMER_TICK_WINDOW
+#define SW_TIMER_TICK_WINDOW 64
+#endif
+
+/**
+ * @brief SW_TIMER_TICK_ENTER macro define number of physical timer
+ * programmings during one window from which the tick mode is entered.
+ */
+#ifndef SW_TIMER_TICK_ENTER
+#define SW_TIMER_TICK_ENTER (2 * SW_TIMER_TICK_WINDOW)
+#endif
+
+/**
+ * @brief SW_TIMER_TICK_LEAVE macro define number of physical timer
+ * programmings during one window below which the tick mode is left, it is
+ * less than SW_TIMER_TICK_ENTER for hysteresis.
+ */
+#ifndef SW_TIMER_TICK_LEAVE
+#define SW_TIMER_TICK_LEAVE (SW_TIMER_TICK_WINDOW / 2)
+#endif
+
+/**
+ * @brief SW_TIMER_EDF_TASKS macro define maximum number of tasks of
+ * the EDF scheduler. EDF scheduler is not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_EDF_TASKS
+#define SW_TIMER_EDF_TASKS 0
+#endif
+
+/**
+ * @brief SW_TIMER_CALENDAR macro enables calendar schedules given by cron
+ * expressions. Calendar schedules are not compiled in if it is 0.
+ */
+#ifndef SW_TIMER_CALENDAR
+#define SW_TIMER_CALENDAR 0
+#endif
+
+/**
+ * @brief SW_TIMER_WALL macro enables wall-clock timers kept in their own
+ * queue by absolute wall time. Wall-clock timers are not compiled in if it
+ * is 0.
+ */
+#ifndef SW_TIMER_WALL
+#define SW_TIMER_WALL 0
+#endif
+
 /**
  * @brief Conversion from seconds to software timer ticks
  */
@@ -30,257 +344,1671 @@
 /**
  * @brief Conversion from microseconds to software timer ticks
  */
-#define SW_TIMER_CONV_MICROSECONDS_TO_TICKS(val) ((val * SW_TIMER_TICK_RATE_HZ) / 1000000)
+#define SW_TIMER_CONV_MICROSECONDS_TO_TICKS(val) ((val * SW_TIMER_TICK_RATE_HZ) / 1000000)
+
+/**
+ * @brief Timer function pointer type.
+ */
+typedef void * sw_timer_func_ptr_t;
+
+/**
+ * @brief Timer argument pointer type.
+ */
+typedef void * sw_timer_arg_ptr_t;
+
+/**
+ * @brief Timer handle type.
+ */
+typedef void * sw_timer_handle_t;
+
+/**
+ * @brief Pool timer id type.
+ *
+ * The id holds the pool slot index in low 16 bits and the slot generation in
+ * high 16 bits. The generation is changed when the slot is released, so ids
+ * of released timers become stale instead of referring to a new timer.
+ */
+typedef uint32_t sw_timer_id_t;
+
+/**
+ * @brief Id that never refers to a pool timer.
+ */
+#define SW_TIMER_ID_NONE 0
+
+/**
+ * @brief Function prototype for a batch callback.
+ *
+ * The function receives arguments of timers that expired together and
+ * share the callback function the batch callback is registered for.
+ */
+typedef void (*sw_timer_batch_func_t)(sw_timer_arg_ptr_t *args, uint32_t count);
+
+/**
+ * @brief Deadline handle type.
+ */
+typedef void * sw_timer_deadline_handle_t;
+
+/**
+ * @brief Function prototype for a TTL map eviction callback.
+ */
+typedef void (*sw_timer_ttl_evict_func_t)(uint64_t key, void *value);
+
+/**
+ * @brief Lease handle type.
+ */
+typedef void * sw_timer_lease_handle_t;
+
+/**
+ * @brief Function prototype for a lease bulk callback.
+ *
+ * The function receives leases delivered by one wakeup of the lease manager.
+ */
+typedef void (*sw_timer_lease_func_t)(sw_timer_lease_handle_t *leases, uint32_t count);
+
+/**
+ * @brief Sliding window counter handle type.
+ */
+typedef void * sw_timer_window_handle_t;
+
+/**
+ * @brief EDF task handle type.
+ */
+typedef void * sw_timer_edf_handle_t;
+
+/**
+ * @brief Calendar schedule handle type.
+ */
+typedef void * sw_timer_calendar_handle_t;
+
+/**
+ * @brief Wall-clock timer handle type.
+ */
+typedef void * sw_timer_wall_handle_t;
+
+/**
+ * @brief Function prototype for a clock returning local time in seconds
+ * since 1970-01-01 00:00:00.
+ */
+typedef uint32_t (*sw_timer_clock_func_t)(void);
+
+/**
+ * @brief Function prototype for a set physical timer.
+ */
+typedef void (*set_physical_sw_timer_func_t)(uint32_t);
+
+/**
+ * @brief Function prototype for a get physical timer counter.
+ */
+typedef uint32_t (*get_physical_sw_timer_counter_func_t)(void);
+
+/**
+ * @brief Function prototype for a wait while the word is equal to the value.
+ *
+ * The function has futex wait semantics: it returns when the word could be
+ * changed, for example after sleeping on a futex, or after an interrupt by
+ * a wait for interrupt instruction. Returning earlier is allowed.
+ */
+typedef void (*sw_timer_wait_func_t)(volatile uint32_t *word, uint32_t value);
+
+/**
+ * @brief Function prototype for a wake of waiters of the word.
+ */
+typedef void (*sw_timer_wake_func_t)(volatile uint32_t *word);
+
+/**
+ * @brief Timer mode type.
+ */
+typedef enum SW_TIMER_MODE
+{
+	SW_TIMER_MODE_SINGLE_SHOT,
+	SW_TIMER_MODE_REPEATING,
+	SW_TIMER_MODE_REPEATING_ALIGNED
+} sw_timer_mode_t;
+
+/**
+ * @brief Timer status type.
+ */
+typedef enum SW_TIMER_STATUS
+{
+	SW_TIMER_STATUS_OK,
+	SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED,
+	SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST,
+	SW_TIMER_STATUS_ERROR_TIMER_STALE,
+	SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST,
+	SW_TIMER_STATUS_ERROR_KEY_INDEX_FULL,
+	SW_TIMER_STATUS_ERROR_BATCH_CALLBACKS_FULL,
+	SW_TIMER_STATUS_ERROR_PARENT_NOT_RUNNING,
+	SW_TIMER_STATUS_ERROR_SCHEDULE_TOO_LARGE,
+	SW_TIMER_STATUS_ERROR_CLOCK_NOT_REGISTERED,
+	SW_TIMER_STATUS_ERROR_SCHEDULE_NEVER_FIRES,
+	SW_TIMER_STATUS_ERROR_RING_DISABLED,
+	SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING,
+	SW_TIMER_STATUS_ERROR_INVALID_ARGUMENT
+} sw_timer_status_t;
+
+/**
+ * @brief Timer statistics type.
+ */
+typedef struct SW_TIMER_STATS
+{
+	// A number of expired timers
+	uint32_t expired;
+
+	// A number of timers stopped or restarted before expiry
+	uint32_t cancelled;
+
+	// A number of timers started in the wheel by SW_TIMER_ENGINE_HYBRID
+	uint32_t wheel_started;
+
+	// A number of timers started in the heap by SW_TIMER_ENGINE_HYBRID
+	uint32_t heap_started;
+
+	// A number of switches between list and heap by SW_TIMER_ENGINE_ADAPTIVE
+	uint32_t migrations;
+
+	// A number of expiries dropped because the expiry ring was full
+	uint32_t ring_dropped;
+
+	// A maximum number of records ever waiting in the expiry ring
+	uint32_t ring_max_used;
+
+	// A number of interrupt handler passes that expired timers
+	uint32_t wakeups;
+
+	// A number of SW_TIMER_MODE_REPEATING_ALIGNED starts moved to the grid
+	uint32_t aligned;
+
+	// A time spent in the tick mode, counted at the end of every window
+	uint32_t tick_time;
+
+	// A time spent in the tickless mode while timers are running
+	uint32_t tickless_time;
+
+	// A number of switches between the tick and tickless modes
+	uint32_t tick_switches;
+} sw_timer_stats_t;
+
+/**
+ * @brief Cyclic executive task type.
+ */
+typedef struct SW_TIMER_CYCLIC_TASK
+{
+	// A release period in ticks
+	uint32_t period;
+
+	// A release offset from the hyperperiod start in ticks, less than period
+	uint32_t offset;
+
+	// A pointer to the task function
+	sw_timer_func_ptr_t callback;
+
+	// A pointer to the task function argument
+	sw_timer_arg_ptr_t arg;
+} sw_timer_cyclic_task_t;
+
+/**
+ * @brief Expiry record type, pushed to the expiry ring.
+ */
+typedef struct SW_TIMER_EXPIRY
+{
+	// A handle of the expired timer
+	sw_timer_handle_t timer;
+
+	// A callback argument of the expired timer
+	sw_timer_arg_ptr_t arg;
+
+	// An expiry time the timer was started for
+	uint32_t deadline;
+
+	// A time the expiry was handled at, later than the deadline by up to
+	// SW_TIMER_TICK_PERIOD in the tick mode
+	uint32_t time;
+} sw_timer_expiry_t;
+
+/**
+ * @brief Timer buffer type.
+ *
+ * In line with software engineering best practice, especially when supplying a
+ * library that is likely to change in future versions, sw_timer implements a
+ * strict data hiding policy. This means the software timer structure used
+ * internally by sw_timer is not accessible to application code. However, if
+ * the application writer wants to statically allocate the memory required to
+ * create a software timer then the size of the queue object needs to be know.
+ * The sw_timer_buffer_t structure below is provided for this purpose. Its sizes
+ * and alignment requirements are guaranteed to match those of the genuine
+ * structure, no matter which architecture is being used. Its contents are
+ * somewhat obfuscated in the hope users will recognize that it would be
+ * unwise to make direct use of the structure members.
+ *
+ */
+typedef struct SW_TIMER_BUFFER
+{
+    uint32_t Dummy1;
+    uint32_t Dummy2;
+    uint32_t Dummy3;
+    uint32_t Dummy4;
+    uint32_t Dummy5;
+    uint8_t Dummy6;
+    uint8_t Dummy7;
+    void *Dummy8;
+    void *Dummy9;
+    void *Dummy10;
+    void *Dummy11;
+#if (SW_TIMER_ENGINE == SW_TIMER_ENGINE_FIFO) || (SW_TIMER_ENGINE == SW_TIMER_ENGINE_RADIX)
+    void *Dummy12;
+#elif SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID
+    void *Dummy12;
+    void *Dummy13;
+#elif SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE
+    void *Dummy12;
+    void *Dummy13;
+    void *Dummy14;
+#endif
+} sw_timer_buffer_t;
+
+/**
+ * @brief Timer buffer with inline payload type.
+ *
+ * The buffer holds the timer and SW_TIMER_PAYLOAD_SIZE bytes of callback
+ * context, so the context needs no separate allocation and is in the same
+ * cache lines as the timer at expiry. The payload is aligned for any scalar
+ * type and pointers.
+ */
+typedef struct SW_TIMER_BUFFER_EX
+{
+    sw_timer_buffer_t Dummy1;
+    union
+    {
+        uint8_t bytes[SW_TIMER_PAYLOAD_SIZE];
+        uint64_t Dummy2;
+        void *Dummy3;
+    } payload;
+} sw_timer_buffer_ex_t;
+
+/**
+ * @brief Deadline buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_DEADLINE_BUFFER
+{
+    sw_timer_buffer_t Dummy1;
+    void *Dummy2;
+    void *Dummy3;
+    void *Dummy4;
+    void *Dummy5;
+    void *Dummy6;
+    void *Dummy7;
+    void *Dummy8;
+    uint32_t Dummy9;
+} sw_timer_deadline_buffer_t;
+
+/**
+ * @brief TTL map entry buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_TTL_ENTRY_BUFFER
+{
+    uint64_t Dummy1;
+    void *Dummy2;
+    void *Dummy3;
+    void *Dummy4;
+    void *Dummy5;
+    uint32_t Dummy6;
+    uint32_t Dummy7;
+} sw_timer_ttl_entry_buffer_t;
+
+/**
+ * @brief Lease buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_LEASE_BUFFER
+{
+    void *Dummy1;
+    void *Dummy2;
+    void *Dummy3;
+    void *Dummy4;
+    uint32_t Dummy5;
+    uint32_t Dummy6;
+    uint32_t Dummy7;
+} sw_timer_lease_buffer_t;
+
+/**
+ * @brief Sliding window counter buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_WINDOW_BUFFER
+{
+    void *Dummy1;
+    uint32_t Dummy2;
+    uint32_t Dummy3;
+    uint32_t Dummy4;
+    uint32_t Dummy5;
+    uint32_t Dummy6[SW_TIMER_WINDOW_BUCKETS];
+} sw_timer_window_buffer_t;
+
+/**
+ * @brief EDF task buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_EDF_BUFFER
+{
+    sw_timer_buffer_t Dummy1;
+    void *Dummy2;
+    void *Dummy3;
+    uint32_t Dummy4;
+    uint32_t Dummy5;
+    uint32_t Dummy6;
+    uint32_t Dummy7;
+    uint32_t Dummy8;
+    uint32_t Dummy9;
+    uint32_t Dummy10;
+} sw_timer_edf_buffer_t;
+
+/**
+ * @brief Wall-clock timer buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_WALL_BUFFER
+{
+    void *Dummy1;
+    void *Dummy2;
+    void *Dummy3;
+    void *Dummy4;
+    uint32_t Dummy5;
+    uint32_t Dummy6;
+    uint32_t Dummy7;
+    uint32_t Dummy8;
+} sw_timer_wall_buffer_t;
+
+/**
+ * @brief Calendar schedule buffer type.
+ *
+ * Like sw_timer_buffer_t, it is provided for static allocation only, its
+ * sizes and alignment requirements match those of the genuine structure.
+ */
+typedef struct SW_TIMER_CALENDAR_BUFFER
+{
+    sw_timer_wall_buffer_t Dummy1;
+    void *Dummy2;
+    void *Dummy3;
+    uint64_t Dummy4;
+    uint32_t Dummy5;
+    uint32_t Dummy6;
+    uint32_t Dummy7;
+    uint32_t Dummy8;
+    uint32_t Dummy9;
+    uint32_t Dummy10;
+} sw_timer_calendar_buffer_t;
+
+/**
+ * @brief Registers physical timer callbacks.
+ *
+ * @param set_physical_timer Callback handler for set physical timer.
+ *
+ * @param get_physical_sw_timer_counter Callback handler for get
+ * physical timer counter.
+ */
+void sw_timer_register_physical_sw_timer_callbacks(
+		set_physical_sw_timer_func_t set_physical_timer,
+		get_physical_sw_timer_counter_func_t get_physical_sw_timer_counter);
+
+/**
+ * @brief Registers wait callbacks used by sw_timer_wait() and
+ * sw_timer_wait_any().
+ *
+ * The wake callback is called by sw_timer_interrupt_handler() for the
+ * expiry word of every expired timer and for the group word once per
+ * interrupt. If callbacks are not registered, waiting is busy polling.
+ *
+ * @param wait Callback handler for wait, for example futex wait on Linux or
+ * wait for interrupt on a microcontroller.
+ *
+ * @param wake Callback handler for wake, for example futex wake on Linux.
+ */
+void sw_timer_register_wait_callbacks(sw_timer_wait_func_t wait, sw_timer_wake_func_t wake);
+
+/**
+ * @brief Creates a new software timer instance, and returns a handle
+ * by which the created software timer can be referenced.
+ *
+ * Application developer must provide the memory buffer sw_timer_buffer_t that will
+ * get used by the software timer. Timer is created in the stopped state.
+ * The sw_timer_start() API function can be used to transition a timer into
+ * the running state.
+ *
+ * @param period The timer period. The time is defined in tick periods so the
+ * macro SW_TIMER_CONV_MILLISECONDS_TO_TICKS can be used to convert a time that
+ * has been specified in milliseconds and macro SW_TIMER_CONV_MICROSECONDS_TO_TICKS
+ * can be used to convert a time that has been specified in microseconds.
+ * For example, if the timer must expire after 100 ticks, then period should be
+ * set to 100. Alternatively, if the timer must expire after 500 milliseconds,
+ * then period can be set to SW_TIMER_CONV_MILLISECONDS_TO_TICKS(500).
+ *
+ * @param mode If mode is set to SW_TIMER_MODE_REPEATING then the timer will
+ * expire repeatedly with a frequency set by the period parameter. If mode is
+ * set to SW_TIMER_MODE_SINGLE_SHOT then the timer will be a one-shot timer and
+ * enter the stopped state after it expires. SW_TIMER_MODE_REPEATING_ALIGNED
+ * is SW_TIMER_MODE_REPEATING whose first expiry is moved by sw_timer_start()
+ * and by sw_timer_update() of a running timer up to SW_TIMER_ALIGN_MAX_SHIFT
+ * later to a multiple of the period or of SW_TIMER_ALIGN_GRANULARITY, so
+ * timers of equal or harmonic periods expire on the same tick and are
+ * handled by one interrupt.
+ *
+ * @param callback The function to call when the timer expires.
+ *
+ * @param arg Argument for the callback function.
+ *
+ * @param sw_timer_buffer_t Must point to a variable of type sw_timer_t,
+ * which is then used to hold the timer’s state.
+ *
+ * @return The handle to the newly created timer.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function.
+ *
+ * Example usage:
+ * @verbatim
+ * void callback_func( void )
+ * {
+ * }
+ *
+ * void main( void )
+ * {
+ *	// Return status code for software timer
+ *	sw_timer_status_t status;
+ *
+ *	// Software timer handle
+ *	sw_timer_handle_t timer;
+ *
+ *	// Memory static allocation for software timer
+ *	sw_timer_buffer_t sw_timer_buffer;
+ *
+ *	// Read PRIMASK register, check interrupt status before you disable them
+ *	// Returns 0 if they are enabled, or non-zero if disabled
+ *	uint32_t prim = __get_PRIMASK();
+ *
+ *	// Disable interrupts
+ *	__disable_irq();
+ *
+ *	timer = sw_timer_create(SW_TIMER_CONV_MILLISECONDS_TO_TICKS(500), SW_TIMER_MODE_SINGLE_SHOT, &callback_func, NULL, &sw_timer_buffer);
+ *
+ *	status = sw_timer_start(timer);
+ *
+ *	status = sw_timer_update(timer, SW_TIMER_CONV_MILLISECONDS_TO_TICKS(100), SW_TIMER_MODE_REPEATING, &callback_func, NULL);
+ *
+ *	status = sw_timer_stop(timer);
+ *
+ *	// Enable interrupts back
+ *	if (!prim) {
+ *		__enable_irq();
+ *	}
+ * }
+ * @endverbatim
+ */
+sw_timer_handle_t sw_timer_create(
+		uint32_t period,
+		sw_timer_mode_t mode,
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		sw_timer_buffer_t *buffer);
+
+/**
+ * @brief Creates a new software timer with inline payload.
+ *
+ * The timer is created by the sw_timer_create() API function with the
+ * pointer to the buffer payload as the callback argument, so the callback
+ * receives its context without extra indirection. The payload is not
+ * cleared, it can be filled before or after the call by the pointer
+ * returned from sw_timer_payload().
+ *
+ * @param period The timer period, see sw_timer_create().
+ *
+ * @param mode The timer mode, see sw_timer_create().
+ *
+ * @param callback The function to call when the timer expires, it receives
+ * the pointer to the payload.
+ *
+ * @param buffer Must point to a variable of type sw_timer_buffer_ex_t.
+ *
+ * @return The handle to the newly created timer.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_handle_t sw_timer_create_ex(
+		uint32_t period,
+		sw_timer_mode_t mode,
+		sw_timer_func_ptr_t callback,
+		sw_timer_buffer_ex_t *buffer);
+
+/**
+ * @brief Returns the inline payload of the timer created by
+ * sw_timer_create_ex().
+ *
+ * Pass it as the argument to sw_timer_update() to keep the callback
+ * receiving the payload.
+ *
+ * @param timer The handle of the timer created with sw_timer_buffer_ex_t.
+ *
+ * @return The pointer to SW_TIMER_PAYLOAD_SIZE bytes of payload.
+ */
+void *sw_timer_payload(sw_timer_handle_t timer);
+
+/**
+ * @brief Updates timer's parameters.
+ *
+ * sw_timer_update() updates a timer parameters for timer that was previously
+ * created using the sw_timer_create() API function. If a timer had not been
+ * started yet, this API function update timer's parameters; but if the
+ * timer had already been started, than this API function update timer's
+ * parameters and restart the timer by the sw_timer_reschedule() API function
+ * with the new period.
+ *
+ * @param timer The handle of the timer that need update it parameters.
+ *
+ * @param period The timer period. The time is defined in tick periods so the
+ * macro SW_TIMER_CONV_MILLISECONDS_TO_TICKS can be used to convert a time that
+ * has been specified in milliseconds and macro SW_TIMER_CONV_MICROSECONDS_TO_TICKS
+ * can be used to convert a time that has been specified in microseconds.
+ * For example, if the timer must expire after 100 ticks, then period should be
+ * set to 100. Alternatively, if the timer must expire after 500 milliseconds,
+ * then period can be set to SW_TIMER_CONV_MILLISECONDS_TO_TICKS(500).
+ *
+ * @param mode If mode is set to SW_TIMER_MODE_REPEATING then the timer will
+ * expire repeatedly with a frequency set by the period parameter. If mode is
+ * set to SW_TIMER_MODE_SINGLE_SHOT then the timer will be a one-shot timer and
+ * enter the stopped state after it expires. SW_TIMER_MODE_REPEATING_ALIGNED
+ * is SW_TIMER_MODE_REPEATING whose first expiry is moved by sw_timer_start()
+ * and by sw_timer_update() of a running timer up to SW_TIMER_ALIGN_MAX_SHIFT
+ * later to a multiple of the period or of SW_TIMER_ALIGN_GRANULARITY, so
+ * timers of equal or harmonic periods expire on the same tick and are
+ * handled by one interrupt.
+ *
+ * @param callback The function to call when the timer expires.
+ *
+ * @param arg Argument for the callback function.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function.
+ *
+ * Example usage:
+ *
+ * See the sw_timer_create() API function example usage scenario.
+ */
+sw_timer_status_t sw_timer_update(
+		sw_timer_handle_t timer,
+		uint32_t period,
+		sw_timer_mode_t mode,
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg);
+
+/**
+ * @brief Starts software timer.
+ *
+ * @param timer The handle of the timer being started/restarted.
+ *
+ * sw_timer_start() starts a timer that was previously created using the
+ * sw_timer_create() API function. If the timer had already been started,
+ * this API function restart the timer.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function.
+ *
+ * Example usage:
+ *
+ * See the sw_timer_create() API function example usage scenario.
+ */
+sw_timer_status_t sw_timer_start(sw_timer_handle_t timer);
+
+/**
+ * @brief Reschedules software timer.
+ *
+ * @param timer The handle of the timer being rescheduled.
+ *
+ * @param delay The time from now to the next timer expiry, in ticks.
+ *
+ * sw_timer_reschedule() moves the next expiry of a running timer to delay
+ * ticks from now. The timer stays queued and is moved from its current
+ * position, so moving it by a short distance is cheap for all engines. The
+ * period of a repeating timer is not changed, following expiries are period
+ * ticks apart. If the timer is not running, this API function starts it with
+ * the delay instead of the period. Delay 0 is handled as 1 tick, because
+ * the physical timer cannot be programmed for 0 ticks.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function.
+ */
+sw_timer_status_t sw_timer_reschedule(sw_timer_handle_t timer, uint32_t delay);
+
+/**
+ * @brief Arms software timer if it expires earlier than now.
+ *
+ * @param timer The handle of the timer being armed.
+ *
+ * @param delay The time from now to the wanted timer expiry, in ticks.
+ *
+ * sw_timer_arm_if_earlier() keeps the earlier of the current and the wanted
+ * expiry. If the timer is running and expires not later than delay ticks
+ * from now, this API function does nothing: the timer is not moved and the
+ * physical timer is not reprogrammed. Otherwise the timer is rescheduled by
+ * the sw_timer_reschedule() API function, or started with the delay if it is
+ * not running. Delay 0 is handled as 1 tick.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function. The check and the arming are
+ * done in one critical section, so no expiry can be lost between them.
+ */
+sw_timer_status_t sw_timer_arm_if_earlier(sw_timer_handle_t timer, uint32_t delay);
+
+/**
+ * @brief Arms software timer if it is not running.
+ *
+ * @param timer The handle of the timer being armed.
+ *
+ * @param delay The time from now to the timer expiry, in ticks.
+ *
+ * sw_timer_arm_if_not_running() starts a stopped timer with the delay
+ * instead of the period. A running timer is left untouched, without any
+ * engine work and without reprogramming the physical timer. Delay 0 is
+ * handled as 1 tick.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function.
+ */
+sw_timer_status_t sw_timer_arm_if_not_running(sw_timer_handle_t timer, uint32_t delay);
+
+/**
+ * @brief Stops software timer.
+ *
+ * @param timer The handle of the timer being stopped.
+ *
+ * Stopping a software timer ensures the timer is not in the running state.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function. Needs disable the interrupt service routine in the
+ * main function before using this function.
+ *
+ * Example usage:
+ *
+ * See the sw_timer_create() API function example usage scenario.
+ */
+sw_timer_status_t sw_timer_stop(sw_timer_handle_t timer);
+
+/**
+ * @brief Creates a new software timer in the static pool.
+ *
+ * The timer is created by the sw_timer_create() API function in a free pool
+ * slot of SW_TIMER_POOL_SIZE ones, so application developer need not provide
+ * the buffer. The returned id stays valid until sw_timer_pool_release() is
+ * called for it, after that the id is stale even if the slot is used again.
+ * Slot generation has 16 bits, so an id could become valid again only after
+ * the slot is reused 32768 times.
+ *
+ * @param period The timer period, see sw_timer_create().
+ *
+ * @param mode The timer mode, see sw_timer_create().
+ *
+ * @param callback The function to call when the timer expires.
+ *
+ * @param arg Argument for the callback function.
+ *
+ * @return The timer id or SW_TIMER_ID_NONE if the pool is full.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_id_t sw_timer_pool_create(
+		uint32_t period,
+		sw_timer_mode_t mode,
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg);
+
+/**
+ * @brief Returns handle of pool timer.
+ *
+ * The handle can be used with all other API functions while the id is valid.
+ *
+ * @param id The timer id.
+ *
+ * @return The timer handle or NULL if the id is stale.
+ */
+sw_timer_handle_t sw_timer_pool_get(sw_timer_id_t id);
+
+/**
+ * @brief Stops pool timer.
+ *
+ * The id is checked in O(1) time, a stale id does not stop the timer that
+ * reuses the slot.
+ *
+ * @param id The timer id.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_TIMER_STALE if the id
+ * is stale.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_pool_stop(sw_timer_id_t id);
+
+/**
+ * @brief Stops pool timer and returns its slot to the pool.
+ *
+ * @param id The timer id.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_TIMER_STALE if the id
+ * is stale.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_pool_release(sw_timer_id_t id);
+
+/**
+ * @brief Binds timer to the key.
+ *
+ * Keyed timers are found by the key index of SW_TIMER_KEY_SLOTS entries,
+ * that uses open addressing, so binding, finding and unbinding a key costs
+ * one probe sequence and needs no memory allocation. If the key is already
+ * bound, it is bound to the new timer. The timer state is not changed.
+ *
+ * @param key The key, for example session id and timer kind packed together.
+ *
+ * @param timer The handle of the timer.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_KEY_INDEX_FULL if
+ * there are no free entries.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_key_bind(uint64_t key, sw_timer_handle_t timer);
+
+/**
+ * @brief Unbinds the key, the timer state is not changed.
+ *
+ * @param key The key.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST if the
+ * key is not bound.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_key_unbind(uint64_t key);
+
+/**
+ * @brief Returns handle of the timer bound to the key.
+ *
+ * @param key The key.
+ *
+ * @return The timer handle or NULL if the key is not bound.
+ */
+sw_timer_handle_t sw_timer_key_find(uint64_t key);
+
+/**
+ * @brief Arms or reschedules the timer bound to the key by the
+ * sw_timer_reschedule() API function.
+ *
+ * @param key The key.
+ *
+ * @param delay The time from now to the next timer expiry, in ticks.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST if the
+ * key is not bound.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_key_reschedule(uint64_t key, uint32_t delay);
+
+/**
+ * @brief Stops the timer bound to the key, the key stays bound.
+ *
+ * @param key The key.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST if the
+ * key is not bound.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_key_stop(uint64_t key);
+
+/**
+ * @brief Registers batch callback for a callback function.
+ *
+ * Timers that expire at the same time and have the callback function are
+ * delivered by one call of the batch callback with up to
+ * SW_TIMER_BATCH_SIZE arguments instead of one call of the callback
+ * function per timer. Calls keep the expiry order: collected arguments are
+ * delivered before any other callback is called. A timer stopped by the
+ * batch callback while handling an earlier argument of the same batch is
+ * still in the batch.
+ *
+ * @param callback The callback function timers are created with.
+ *
+ * @param batch The batch callback, NULL to unregister.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_BATCH_CALLBACKS_FULL
+ * if SW_TIMER_BATCH_CALLBACKS functions are already registered.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_register_batch_callback(sw_timer_func_ptr_t callback, sw_timer_batch_func_t batch);
+
+/**
+ * @brief Enables or disables delivery of timer expiries to the expiry ring.
+ *
+ * Expiries of a timer with ring delivery enabled are pushed to the ring by
+ * sw_timer_interrupt_handler() and its callback is not called. Other timers,
+ * including the internal timers of other components, keep their callbacks.
+ *
+ * @param timer The handle of the timer.
+ *
+ * @param enable Non-zero value to push expiries to the ring, 0 to call the
+ * callback.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_RING_DISABLED if
+ * SW_TIMER_RING_SIZE is 0.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_ring_delivery(sw_timer_handle_t timer, uint32_t enable);
+
+/**
+ * @brief Pops expiry records from the expiry ring.
+ *
+ * The ring has single producer, sw_timer_interrupt_handler(), and single
+ * consumer, the caller of this function, so the function can be called
+ * with the interrupt enabled. When the ring is full, new expiries are
+ * dropped and counted in ring_dropped statistics counter.
+ *
+ * @param records The pointer to array that need be filled.
+ *
+ * @param max The array size.
+ *
+ * @return Number of popped records.
+ */
+uint32_t sw_timer_ring_pop(sw_timer_expiry_t *records, uint32_t max);
+
+/**
+ * @brief Returns number of timer expiries.
+ *
+ * The value is passed to sw_timer_wait() to wait for the next expiry, it
+ * must be read before the timer is started, so the expiry cannot be missed.
+ *
+ * @param timer The handle of the timer.
+ *
+ * @return Number of expiries from the timer creation, it wraps around.
+ */
+uint32_t sw_timer_expiries(sw_timer_handle_t timer);
+
+/**
+ * @brief Waits for the timer expiry.
+ *
+ * The calling thread waits on the timer expiry word and is woken directly
+ * by the interrupt handler, only when the timer expires or is stopped. This
+ * API function must be called with the interrupt enabled.
+ *
+ * Example usage:
+ * @verbatim
+ *	uint32_t expiries = sw_timer_expiries(timer);
+ *
+ *	sw_timer_start(timer);
+ *
+ *	sw_timer_wait(timer, expiries);
+ * @endverbatim
+ *
+ * @param timer The handle of the timer.
+ *
+ * @param expiries The number of expiries returned by sw_timer_expiries().
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING if
+ * the timer is stopped without expiry.
+ */
+sw_timer_status_t sw_timer_wait(sw_timer_handle_t timer, uint32_t expiries);
+
+/**
+ * @brief Waits for expiry of any timer of the group.
+ *
+ * The calling thread waits on one word shared by all group waits, so the
+ * group costs no memory. The word is changed only when a timer some group
+ * waits for expires or is stopped, other interrupts wake no group waiter.
+ *
+ * @param timers The array of timer handles.
+ *
+ * @param expiries The array of numbers of expiries returned by
+ * sw_timer_expiries() for every timer.
+ *
+ * @param count The number of timers.
+ *
+ * @param index The pointer to the index of expired timer that need be
+ * filled.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING if
+ * all timers are stopped without expiry.
+ */
+sw_timer_status_t sw_timer_wait_any(
+		const sw_timer_handle_t *timers,
+		const uint32_t *expiries,
+		uint32_t count,
+		uint32_t *index);
+
+/**
+ * @brief Returns the current time.
+ *
+ * The time is counted in ticks and wraps around, only differences of two
+ * values are meaningful. It stands still while no timers are running.
+ *
+ * @return The current time.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+uint32_t sw_timer_now(void);
+
+/**
+ * @brief Returns time to the next timer expiry.
+ *
+ * @param timer The handle of the timer.
+ *
+ * @return The time from now to the next expiry in ticks, 0 if the timer is
+ * not running.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+uint32_t sw_timer_remaining(sw_timer_handle_t timer);
+
+/**
+ * @brief Returns whether the timer is running.
+ *
+ * In the tick mode a running timer can be already due, so
+ * sw_timer_remaining() returns 0 for it.
+ *
+ * @param timer The handle of the timer.
+ *
+ * @return Non-zero value if the timer is started and has not expired or
+ * been stopped since.
+ */
+uint32_t sw_timer_is_running(sw_timer_handle_t timer);
+
+/**
+ * @brief Creates a new deadline.
+ *
+ * Deadlines form a tree, a child deadline never expires later than its
+ * parent. A child deadline that is not earlier than the parent one does
+ * not start its own timer at all. When a deadline expires or is cancelled,
+ * all its descendants expire or are cancelled with it by one walk of the
+ * subtree.
+ *
+ * @param callback The function to call when the deadline expires, by its
+ * own timer or together with an ancestor.
+ *
+ * @param arg Argument for the callback function.
+ *
+ * @param buffer Must point to a variable of type sw_timer_deadline_buffer_t.
+ *
+ * @return The handle to the newly created deadline.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_deadline_handle_t sw_timer_deadline_create(
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		sw_timer_deadline_buffer_t *buffer);
+
+/**
+ * @brief Starts deadline.
+ *
+ * If the deadline had already been started, it is cancelled together with
+ * its descendants first. Callbacks of an expired subtree are called after
+ * the whole subtree is stopped, children before parents.
+ *
+ * @param deadline The handle of the deadline being started.
+ *
+ * @param parent The handle of the running parent deadline, NULL for a root.
+ *
+ * @param delay The time from now to the deadline, in ticks.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_PARENT_NOT_RUNNING if
+ * the parent has expired or has been cancelled.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_deadline_start(
+		sw_timer_deadline_handle_t deadline,
+		sw_timer_deadline_handle_t parent,
+		uint32_t delay);
+
+/**
+ * @brief Cancels deadline and all its descendants, callbacks are not called.
+ *
+ * @param deadline The handle of the deadline being cancelled.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_deadline_cancel(sw_timer_deadline_handle_t deadline);
+
+/**
+ * @brief Registers TTL map eviction callback.
+ *
+ * The callback is called for entries evicted by the wheel and for expired
+ * entries found by sw_timer_ttl_get(), after the entry is removed from the
+ * map. The entry buffer can be used again by the callback.
+ *
+ * @param callback Callback handler for eviction.
+ */
+void sw_timer_ttl_register_evict_callback(sw_timer_ttl_evict_func_t callback);
+
+/**
+ * @brief Puts entry to the TTL map.
+ *
+ * Entries are kept in SW_TIMER_TTL_BUCKETS hash buckets and in a wheel of
+ * SW_TIMER_TTL_SLOTS slots, one internal timer steps the wheel every
+ * SW_TIMER_TTL_RESOLUTION ticks while the map is not empty. Putting and
+ * removing an entry costs O(1) and no timer is started per entry. An
+ * entry with the same key is replaced without eviction callback.
+ *
+ * @param key The entry key.
+ *
+ * @param value The entry value.
+ *
+ * @param ttl The entry time to live, in ticks.
+ *
+ * @param buffer Must point to a variable of type
+ * sw_timer_ttl_entry_buffer_t, that is not in the map.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_ttl_put(uint64_t key, void *value, uint32_t ttl, sw_timer_ttl_entry_buffer_t *buffer);
+
+/**
+ * @brief Finds entry value in the TTL map.
+ *
+ * An entry that has expired but has not been evicted by the wheel yet is
+ * evicted by this API function.
+ *
+ * @param key The entry key.
+ *
+ * @return The entry value or NULL if there is no entry with the key.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+void *sw_timer_ttl_get(uint64_t key);
+
+/**
+ * @brief Removes entry from the TTL map without eviction callback.
+ *
+ * @param key The entry key.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST if
+ * there is no entry with the key.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_ttl_remove(uint64_t key);
+
+/**
+ * @brief Returns number of entries in the TTL map.
+ *
+ * @return Number of entries, including expired ones not evicted yet.
+ */
+uint32_t sw_timer_ttl_count(void);
+
+/**
+ * @brief Registers lease manager bulk callbacks.
+ *
+ * The renew callback receives leases whose renewal time has come, a lease
+ * is renewed by granting it again. The expire callback receives leases
+ * that were not granted again until their expiry, they are released
+ * before the call. Callbacks can grant and release any lease, a lease
+ * released while handling an earlier lease of the same call is still in
+ * the call.
+ *
+ * @param renew Callback handler for renewals.
+ *
+ * @param expire Callback handler for expiries.
+ */
+void sw_timer_lease_register_callbacks(sw_timer_lease_func_t renew, sw_timer_lease_func_t expire);
+
+/**
+ * @brief Creates lease, the lease is not granted.
+ *
+ * @param arg The lease argument returned by sw_timer_lease_arg().
+ *
+ * @param buffer Must point to a variable of type sw_timer_lease_buffer_t,
+ * which will be then used to hold the lease's data structures.
+ *
+ * @return The lease handle.
+ */
+sw_timer_lease_handle_t sw_timer_lease_create(void *arg, sw_timer_lease_buffer_t *buffer);
+
+/**
+ * @brief Returns lease argument.
+ *
+ * @param handle The handle of the lease.
+ *
+ * @return The lease argument.
+ */
+void *sw_timer_lease_arg(sw_timer_lease_handle_t handle);
+
+/**
+ * @brief Grants or renews lease.
+ *
+ * Leases are kept in a wheel of SW_TIMER_LEASE_SLOTS slots of
+ * SW_TIMER_LEASE_GRANULARITY ticks each, one internal timer wakes up only
+ * for slots that have leases. The renewal is delivered at the start of the
+ * interval the renewal time is in, so all leases due in one interval share
+ * one wakeup and one bulk callback call. Granting costs O(1) and no timer
+ * is started per lease.
+ *
+ * @param handle The handle of the lease.
+ *
+ * @param duration The time from now to the lease expiry, in ticks.
+ *
+ * @param renew_ahead The time before the expiry the renewal is delivered
+ * at the latest, in ticks. The renewal is delivered on the next tick if it
+ * is not less than the duration.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_lease_grant(sw_timer_lease_handle_t handle, uint32_t duration, uint32_t renew_ahead);
+
+/**
+ * @brief Releases lease without callbacks.
+ *
+ * @param handle The handle of the lease.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_lease_release(sw_timer_lease_handle_t handle);
+
+/**
+ * @brief Returns number of lease manager wakeups.
+ *
+ * @return Number of wakeups from the program start, it wraps around.
+ */
+uint32_t sw_timer_lease_wakeups(void);
+
+/**
+ * @brief Creates sliding window counter.
+ *
+ * The counter sums values added during the last length buckets of width
+ * ticks. All counters of one width share one repeating rotation timer that
+ * only counts rotations, buckets of a counter are rotated lazily when the
+ * counter is used, so the timer costs O(1) per rotation for any number of
+ * counters.
+ *
+ * @param width The bucket width, in ticks.
+ *
+ * @param length The number of buckets, up to SW_TIMER_WINDOW_BUCKETS.
+ *
+ * @param buffer Must point to a variable of type sw_timer_window_buffer_t,
+ * which will be then used to hold the counter's data structures.
+ *
+ * @return The counter handle or NULL if the length is not valid or
+ * SW_TIMER_WINDOW_CLOCKS other widths are already used.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_window_handle_t sw_timer_window_create(uint32_t width, uint32_t length, sw_timer_window_buffer_t *buffer);
+
+/**
+ * @brief Deletes sliding window counter, the rotation timer is stopped
+ * with the last counter of its width.
+ *
+ * The handle is not valid after the counter is deleted. Only deleting it
+ * again is detected, other counter functions must not be called until the
+ * buffer is used by sw_timer_window_create() again.
+ *
+ * @param handle The handle of the counter.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST if
+ * the counter is deleted already.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_window_delete(sw_timer_window_handle_t handle);
 
 /**
- * @brief Timer function pointer type.
+ * @brief Adds value to the current bucket of sliding window counter.
+ *
+ * The rotation timer only increments the rotation count, so the function
+ * can be called with the interrupt enabled if the counter is not used by
+ * other contexts.
+ *
+ * @param handle The handle of the counter.
+ *
+ * @param value The value.
  */
-typedef void * sw_timer_func_ptr_t;
+void sw_timer_window_add(sw_timer_window_handle_t handle, uint32_t value);
 
 /**
- * @brief Timer argument pointer type.
+ * @brief Returns sum of all buckets of sliding window counter.
+ *
+ * @param handle The handle of the counter.
+ *
+ * @return The sum, including the current bucket.
  */
-typedef void * sw_timer_arg_ptr_t;
+uint32_t sw_timer_window_sum(sw_timer_window_handle_t handle);
 
 /**
- * @brief Timer handle type.
+ * @brief Returns sum of the last buckets of sliding window counter, so one
+ * counter serves several window lengths.
+ *
+ * @param handle The handle of the counter.
+ *
+ * @param length The number of the last buckets, including the current one.
+ *
+ * @return The sum.
  */
-typedef void * sw_timer_handle_t;
+uint32_t sw_timer_window_sum_last(sw_timer_window_handle_t handle, uint32_t length);
 
 /**
- * @brief Function prototype for a set physical timer.
+ * @brief Builds the cyclic executive schedule table.
+ *
+ * The frame length is the greatest common divisor of all periods and
+ * offsets, the table covers one hyperperiod, the least common multiple of
+ * all periods. Every frame lists tasks released at its start in the task
+ * set order, so dispatching a frame is a table lookup without sorting.
+ * The running schedule is stopped, a failed call keeps the previous table.
+ *
+ * @param task_set The pointer to tasks, it must stay valid while the
+ * schedule is used.
+ *
+ * @param count The number of tasks.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_INVALID_ARGUMENT if
+ * the task set is NULL or empty or a task has zero period or an offset not
+ * below its period, SW_TIMER_STATUS_ERROR_SCHEDULE_TOO_LARGE if there are
+ * more than SW_TIMER_CYCLIC_TASKS tasks or the table does not fit
+ * SW_TIMER_CYCLIC_FRAMES frames or SW_TIMER_CYCLIC_ENTRIES entries.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
  */
-typedef void (*set_physical_sw_timer_func_t)(uint32_t);
+sw_timer_status_t sw_timer_cyclic_init(const sw_timer_cyclic_task_t *task_set, uint32_t count);
 
 /**
- * @brief Function prototype for a get physical timer counter.
+ * @brief Starts the cyclic executive, one repeating timer dispatches the
+ * frames. The first frame is dispatched one frame length after the start,
+ * so every release of the table is one frame length later than its offset
+ * counted from the start.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
  */
-typedef uint32_t (*get_physical_sw_timer_counter_func_t)(void);
+sw_timer_status_t sw_timer_cyclic_start(void);
 
 /**
- * @brief Timer mode type.
+ * @brief Stops the cyclic executive.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
  */
-typedef enum SW_TIMER_MODE
-{
-	SW_TIMER_MODE_SINGLE_SHOT,
-	SW_TIMER_MODE_REPEATING
-} sw_timer_mode_t;
+sw_timer_status_t sw_timer_cyclic_stop(void);
 
 /**
- * @brief Timer status type.
+ * @brief Returns the frame length of the schedule.
+ *
+ * @return The frame length in ticks, 0 if there is no schedule.
  */
-typedef enum SW_TIMER_STATUS
-{
-	SW_TIMER_STATUS_OK,
-	SW_TIMER_STATUS_ERROR_PHYSICAL_TIMER_CALLBACKS_NOT_REGISTERED,
-	SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST
-} sw_timer_status_t;
+uint32_t sw_timer_cyclic_minor_cycle(void);
 
 /**
- * @brief Timer buffer type.
+ * @brief Creates EDF task, the task is not released.
  *
- * In line with software engineering best practice, especially when supplying a
- * library that is likely to change in future versions, sw_timer implements a
- * strict data hiding policy. This means the software timer structure used
- * internally by sw_timer is not accessible to application code. However, if
- * the application writer wants to statically allocate the memory required to
- * create a software timer then the size of the queue object needs to be know.
- * The sw_timer_buffer_t structure below is provided for this purpose. Its sizes
- * and alignment requirements are guaranteed to match those of the genuine
- * structure, no matter which architecture is being used. Its contents are
- * somewhat obfuscated in the hope users will recognize that it would be
- * unwise to make direct use of the structure members.
+ * @param callback The task function, run by sw_timer_edf_run().
+ *
+ * @param arg Argument for the task function.
+ *
+ * @param relative_deadline The time from the release to the deadline of
+ * every job of the task, in ticks.
+ *
+ * @param buffer Must point to a variable of type sw_timer_edf_buffer_t,
+ * which will be then used to hold the task's data structures.
  *
+ * @return The task handle or NULL if SW_TIMER_EDF_TASKS tasks are created
+ * already.
  */
-typedef struct SW_TIMER_BUFFER
-{
-    uint32_t Dummy1;
-    uint32_t Dummy2;
-    uint32_t Dummy3;
-    void *Dummy4;
-    void *Dummy5;
-    void *Dummy6;
-    void *Dummy7;
-} sw_timer_buffer_t;
+sw_timer_edf_handle_t sw_timer_edf_create(
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		uint32_t relative_deadline,
+		sw_timer_edf_buffer_t *buffer);
 
 /**
- * @brief Registers physical timer callbacks.
+ * @brief Releases the next job of EDF task after the delay.
  *
- * @param set_physical_timer Callback handler for set physical timer.
+ * A sleeping task is a running timer of the timer queue. Its expiry, in
+ * sw_timer_interrupt_handler(), puts the task to the ready queue ordered by
+ * absolute deadline in O(log n) instead of running a callback. A task
+ * sleeping or ready already is released again.
  *
- * @param get_physical_sw_timer_counter Callback handler for get
- * physical timer counter.
+ * @param handle The handle of the task.
+ *
+ * @param delay The time from now to the release, 0 to release at once.
+ *
+ * @return The timer status code.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
  */
-void sw_timer_register_physical_sw_timer_callbacks(
-		set_physical_sw_timer_func_t set_physical_timer,
-		get_physical_sw_timer_counter_func_t get_physical_sw_timer_counter);
+sw_timer_status_t sw_timer_edf_release_after(sw_timer_edf_handle_t handle, uint32_t delay);
 
 /**
- * @brief Creates a new software timer instance, and returns a handle
- * by which the created software timer can be referenced.
+ * @brief Cancels sleeping or ready EDF task.
  *
- * Application developer must provide the memory buffer sw_timer_buffer_t that will
- * get used by the software timer. Timer is created in the stopped state.
- * The sw_timer_start() API function can be used to transition a timer into
- * the running state.
+ * @param handle The handle of the task.
  *
- * @param period The timer period. The time is defined in tick periods so the
- * macro SW_TIMER_CONV_MILLISECONDS_TO_TICKS can be used to convert a time that
- * has been specified in milliseconds and macro SW_TIMER_CONV_MICROSECONDS_TO_TICKS
- * can be used to convert a time that has been specified in microseconds.
- * For example, if the timer must expire after 100 ticks, then period should be
- * set to 100. Alternatively, if the timer must expire after 500 milliseconds,
- * then period can be set to SW_TIMER_CONV_MILLISECONDS_TO_TICKS(500).
+ * @return The timer status code.
  *
- * @param mode If mode is set to SW_TIMER_MODE_REPEATING then the timer will
- * expire repeatedly with a frequency set by the period parameter. If mode is
- * set to SW_TIMER_MODE_SINGLE_SHOT then the timer will be a one-shot timer and
- * enter the stopped state after it expires.
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_edf_cancel(sw_timer_edf_handle_t handle);
+
+/**
+ * @brief Takes the ready EDF task with the earliest deadline.
  *
- * @param callback The function to call when the timer expires.
+ * Example usage:
+ * @verbatim
+ *	disable_interrupt();
+ *	task = sw_timer_edf_next();
+ *	enable_interrupt();
  *
- * @param arg Argument for the callback function.
+ *	if (task != NULL) {
+ *		sw_timer_edf_run(task);
  *
- * @param sw_timer_buffer_t Must point to a variable of type sw_timer_t,
- * which is then used to hold the timer’s state.
+ *		disable_interrupt();
+ *		sw_timer_edf_complete(task);
+ *		enable_interrupt();
+ *	}
+ * @endverbatim
  *
- * @return The handle to the newly created timer.
+ * @return The task handle or NULL if no task is ready.
  *
  * @note Make sure that the interrupt cannot occur during the execution
- * of this function. Needs disable the interrupt service routine in the
- * main function before using this function.
+ * of this function.
+ */
+sw_timer_edf_handle_t sw_timer_edf_next(void);
+
+/**
+ * @brief Runs the task function of EDF task taken by sw_timer_edf_next(),
+ * it can be called with the interrupt enabled. The task function can
+ * release the next job of the task.
  *
- * Example usage:
- * @verbatim
- * void callback_func( void )
- * {
- * }
+ * @param handle The handle of the task.
+ */
+void sw_timer_edf_run(sw_timer_edf_handle_t handle);
+
+/**
+ * @brief Completes the job taken by sw_timer_edf_next() and counts it
+ * missed if it completes after its deadline.
  *
- * void main( void )
- * {
- *	// Return status code for software timer
- *	sw_timer_status_t status;
+ * Deadlines are measured by sw_timer_now(). A clock timer runs while jobs
+ * are ready or taken, so the time does not stand still before they
+ * complete even if no other timer runs.
  *
- *	// Software timer handle
- *	sw_timer_handle_t timer;
+ * @param handle The handle of the task.
  *
- *	// Memory static allocation for software timer
- *	sw_timer_buffer_t sw_timer_buffer;
+ * @return The timer status code.
  *
- *	// Read PRIMASK register, check interrupt status before you disable them
- *	// Returns 0 if they are enabled, or non-zero if disabled
- *	uint32_t prim = __get_PRIMASK();
+ * @note Make sure that the interrupt cannot occur during the execution
+ * of this function.
+ */
+sw_timer_status_t sw_timer_edf_complete(sw_timer_edf_handle_t handle);
+
+/**
+ * @brief Returns number of EDF jobs completed after their deadline.
  *
- *	// Disable interrupts
- *	__disable_irq();
+ * @param handle The handle of the task, NULL for all tasks.
  *
- *	timer = sw_timer_create(SW_TIMER_CONV_MILLISECONDS_TO_TICKS(500), SW_TIMER_MODE_SINGLE_SHOT, &callback_func, NULL, &sw_timer_buffer);
+ * @return Number of missed deadlines, it wraps around.
+ */
+uint32_t sw_timer_edf_misses(sw_timer_edf_handle_t handle);
+
+/**
+ * @brief Creates calendar schedule, the schedule is not started.
  *
- *	status = sw_timer_start(timer);
+ * The expression has five fields separated by spaces: minute (0 - 59),
+ * hour (0 - 23), day of month (1 - 31), month (1 - 12) and day of week
+ * (0 - 7, both 0 and 7 are Sunday). A field is "*", a value, a range
+ * "first-last" or a comma separated list of them, each optionally
+ * followed by "/step". If both day fields are not "*", days matching
+ * either of them match. Fields are matched against the clock registered by
+ * sw_timer_wall_register_clock(), so it returns local time when schedules
+ * are given in local time.
  *
- *	status = sw_timer_update(timer, SW_TIMER_CONV_MILLISECONDS_TO_TICKS(100), SW_TIMER_MODE_REPEATING, &callback_func, NULL);
+ * @param expression The cron expression, e.g. "0,30 8-17 * * 1-5".
  *
- *	status = sw_timer_stop(timer);
+ * @param callback The callback function called at every fire time.
  *
- *	// Enable interrupts back
- *	if (!prim) {
- *		__enable_irq();
- *	}
- * }
- * @endverbatim
+ * @param arg Argument for the callback function.
+ *
+ * @param buffer Must point to a variable of type sw_timer_calendar_buffer_t,
+ * which will be then used to hold the schedule's data structures.
+ *
+ * @return The schedule handle or NULL if the expression is invalid.
  */
-sw_timer_handle_t sw_timer_create(
-		uint32_t period,
-		sw_timer_mode_t mode,
+sw_timer_calendar_handle_t sw_timer_calendar_create(
+		const char *expression,
 		sw_timer_func_ptr_t callback,
 		sw_timer_arg_ptr_t arg,
-		sw_timer_buffer_t *buffer);
+		sw_timer_calendar_buffer_t *buffer);
 
 /**
- * @brief Updates timer's parameters.
+ * @brief Starts calendar schedule from the current clock time.
  *
- * sw_timer_update() updates a timer parameters for timer that was previously
- * created using the sw_timer_create() API function. If a timer had not been
- * started yet, this API function update timer's parameters; but if the
- * timer had already been started, than this API function first call the
- * sw_timer_stop() API function, than update timer's parameters, and finally
- * call the sw_timer_start() API function.
+ * The schedule is a wall-clock timer restarted at the next fire time after
+ * every fire, so it shares the wakeup timer of the wall-clock queue and
+ * sw_timer_wall_clock_changed() finds its fire time again after a clock
+ * step.
  *
- * @param timer The handle of the timer that need update it parameters.
+ * @note Make sure that the interrupt cannot occur during the execution of this function.
  *
- * @param period The timer period. The time is defined in tick periods so the
- * macro SW_TIMER_CONV_MILLISECONDS_TO_TICKS can be used to convert a time that
- * has been specified in milliseconds and macro SW_TIMER_CONV_MICROSECONDS_TO_TICKS
- * can be used to convert a time that has been specified in microseconds.
- * For example, if the timer must expire after 100 ticks, then period should be
- * set to 100. Alternatively, if the timer must expire after 500 milliseconds,
- * then period can be set to SW_TIMER_CONV_MILLISECONDS_TO_TICKS(500).
+ * @param handle The handle of the schedule.
  *
- * @param mode If mode is set to SW_TIMER_MODE_REPEATING then the timer will
- * expire repeatedly with a frequency set by the period parameter. If mode is
- * set to SW_TIMER_MODE_SINGLE_SHOT then the timer will be a one-shot timer and
- * enter the stopped state after it expires.
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_CLOCK_NOT_REGISTERED
+ * if no wall clock is registered, SW_TIMER_STATUS_ERROR_SCHEDULE_NEVER_FIRES
+ * if no fire time is found before 2106.
+ */
+sw_timer_status_t sw_timer_calendar_start(sw_timer_calendar_handle_t handle);
+
+/**
+ * @brief Stops calendar schedule.
  *
- * @param callback The function to call when the timer expires.
+ * @note Make sure that the interrupt cannot occur during the execution of this function.
  *
- * @param arg Argument for the callback function.
+ * @param handle The handle of the schedule.
  *
  * @return The timer status code.
+ */
+sw_timer_status_t sw_timer_calendar_stop(sw_timer_calendar_handle_t handle);
+
+/**
+ * @brief Returns the next fire time of calendar schedule.
  *
- * @note Make sure that the interrupt cannot occur during the execution
- * of this function. Needs disable the interrupt service routine in the
- * main function before using this function.
+ * @param handle The handle of the schedule.
  *
- * Example usage:
+ * @return The fire time, in seconds since 1970-01-01 00:00:00.
+ */
+uint32_t sw_timer_calendar_next(sw_timer_calendar_handle_t handle);
+
+/**
+ * @brief Registers the clock used by wall-clock timers.
  *
- * See the sw_timer_create() API function example usage scenario.
+ * @param clock_func Callback returning wall time in seconds since
+ * 1970-01-01 00:00:00.
  */
-sw_timer_status_t sw_timer_update(
-		sw_timer_handle_t timer,
-		uint32_t period,
-		sw_timer_mode_t mode,
+void sw_timer_wall_register_clock(sw_timer_clock_func_t clock_func);
+
+/**
+ * @brief Gets the wall time from the registered clock.
+ *
+ * @param time The pointer to the wall time that need be filled, in seconds
+ * since 1970-01-01 00:00:00.
+ *
+ * @return The timer status code, SW_TIMER_STATUS_ERROR_CLOCK_NOT_REGISTERED
+ * if no wall clock is registered.
+ */
+sw_timer_status_t sw_timer_wall_now(uint32_t *time);
+
+/**
+ * @brief Creates wall-clock timer, the timer is not started.
+ *
+ * @param callback The callback function called from the interrupt handler
+ * when the wall clock reaches the expiry.
+ *
+ * @param arg Argument for the callback function.
+ *
+ * @param buffer Must point to a variable of type sw_timer_wall_buffer_t,
+ * which will be then used to hold the timer's data structures.
+ *
+ * @return The timer handle.
+ */
+sw_timer_wall_handle_t sw_timer_wall_create(
 		sw_timer_func_ptr_t callback,
-		sw_timer_arg_ptr_t arg);
+		sw_timer_arg_ptr_t arg,
+		sw_timer_wall_buffer_t *buffer);
 
 /**
- * @brief Starts software timer.
+ * @brief Starts or restarts wall-clock timer at the absolute wall time.
  *
- * @param timer The handle of the timer being started/restarted.
+ * All wall-clock timers share one software timer armed for the earliest of
+ * them. A time not later than now expires at the next tick.
  *
- * sw_timer_start() starts a timer that was previously created using the
- * sw_timer_create() API function. If the timer had already been started,
- * this API function restart the timer.
+ * @note Make sure that the interrupt cannot occur during the execution of this function.
+ *
+ * @param handle The handle of the timer.
+ *
+ * @param time The expiry wall time, in seconds since 1970-01-01 00:00:00.
+ *
+ * @param period The period of following expiries in seconds, 0 for
+ * single-shot timer. Periods missed by a forward clock step are skipped.
  *
  * @return The timer status code.
+ */
+sw_timer_status_t sw_timer_wall_start_at(sw_timer_wall_handle_t handle, uint32_t time, uint32_t period);
+
+/**
+ * @brief Stops wall-clock timer.
  *
- * @note Make sure that the interrupt cannot occur during the execution
- * of this function. Needs disable the interrupt service routine in the
- * main function before using this function.
+ * @note Make sure that the interrupt cannot occur during the execution of this function.
  *
- * Example usage:
+ * @param handle The handle of the timer.
  *
- * See the sw_timer_create() API function example usage scenario.
+ * @return The timer status code.
  */
-sw_timer_status_t sw_timer_start(sw_timer_handle_t timer);
+sw_timer_status_t sw_timer_wall_stop(sw_timer_wall_handle_t handle);
 
 /**
- * @brief Stops software timer.
+ * @brief Returns the next expiry of wall-clock timer.
  *
- * @param timer The handle of the timer being stopped.
+ * @param handle The handle of the timer.
  *
- * Stopping a software timer ensures the timer is not in the running state.
+ * @return The expiry wall time, in seconds since 1970-01-01 00:00:00.
+ */
+uint32_t sw_timer_wall_expiry(sw_timer_wall_handle_t handle);
+
+/**
+ * @brief Enables or disables making wall-clock timer due at once after a
+ * clock step.
+ *
+ * The callback of a timer with this enabled is called at the next tick after
+ * sw_timer_wall_clock_changed() even if its expiry has not come, so it can
+ * find the expiry again from the new wall time, like calendar schedules do.
+ * Other timers keep their absolute expiry.
+ *
+ * @note Make sure that the interrupt cannot occur during the execution of this function.
+ *
+ * @param handle The handle of the timer.
+ *
+ * @param enable Non-zero value to make the timer due after a clock step, 0
+ * to keep its expiry.
  *
  * @return The timer status code.
+ */
+sw_timer_status_t sw_timer_wall_refind_on_step(sw_timer_wall_handle_t handle, uint32_t enable);
+
+/**
+ * @brief Handles a step of the wall clock.
  *
- * @note Make sure that the interrupt cannot occur during the execution
- * of this function. Needs disable the interrupt service routine in the
- * main function before using this function.
+ * Must be called after the wall clock is set, e.g. when a Linux timerfd
+ * created with TFD_TIMER_CANCEL_ON_SET reports ECANCELED. Timers due after
+ * a forward step expire at the next tick, repeating timers left more than
+ * one period ahead by a backward step are moved back by whole periods and
+ * timers enabled by sw_timer_wall_refind_on_step(), like calendar schedules,
+ * are due at once to find their expiry again. Only the wall-clock
+ * queue is visited, in one pass, software timers are not touched.
  *
- * Example usage:
+ * @note Make sure that the interrupt cannot occur during the execution of this function.
+ */
+void sw_timer_wall_clock_changed(void);
+
+/**
+ * @brief Gets software timer statistics.
  *
- * See the sw_timer_create() API function example usage scenario.
+ * Counters are counted from the program start and wrap around.
+ *
+ * @param stats The pointer to statistics that need be filled.
  */
-sw_timer_status_t sw_timer_stop(sw_timer_handle_t timer);
+void sw_timer_get_stats(sw_timer_stats_t *stats);
 
 /**
  * @brief	Timer interrupt handler.
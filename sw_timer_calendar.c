@@ -0,0 +1,498 @@
+#include <assert.h>
+
+#include "sw_timer.h"
+
+#if SW_TIMER_CALENDAR > 0
+
+#if SW_TIMER_WALL == 0
+#error "Calendar schedules are wall-clock timers, SW_TIMER_WALL must not be 0"
+#endif
+
+/**
+ * @brief Calendar flag set if the day of month field is "*".
+ */
+#define SW_TIMER_CALENDAR_FLAG_ANY_DAY 0x00000001
+
+/**
+ * @brief Calendar flag set if the day of week field is "*".
+ */
+#define SW_TIMER_CALENDAR_FLAG_ANY_WEEKDAY 0x00000002
+
+/**
+ * @brief Maximum number of search steps, enough to find the 29th of
+ * February eight years ahead.
+ */
+#define SW_TIMER_CALENDAR_MAX_STEPS 4096
+
+/**
+ * @brief Calendar schedule type.
+ */
+typedef struct SW_TIMER_CALENDAR_SCHEDULE
+{
+	// A wall-clock timer waiting for the next fire time
+	sw_timer_wall_buffer_t timer;
+
+	// A pointer to the callback function
+	sw_timer_func_ptr_t callback;
+
+	// A pointer to the callback function argument
+	sw_timer_arg_ptr_t arg;
+
+	// Minutes 0 - 59 bitset
+	uint64_t minutes;
+
+	// Hours 0 - 23 bitset
+	uint32_t hours;
+
+	// Days of month 1 - 31 bitset
+	uint32_t days;
+
+	// Months 1 - 12 bitset
+	uint32_t months;
+
+	// Days of week 0 - 6 bitset, 0 is Sunday
+	uint32_t weekdays;
+
+	// Calendar flags
+	uint32_t flags;
+
+	// The next fire time, in seconds
+	uint32_t next;
+} sw_timer_calendar_t;
+
+/**
+ * @brief Parses one expression field to bitset.
+ *
+ * @param expression The pointer to expression pointer, moved after the field.
+ *
+ * @param min The minimum field value.
+ *
+ * @param max The maximum field value.
+ *
+ * @param bits The pointer to bitset that need be filled.
+ *
+ * @return Non-zero value if the field is valid, 2 if it is "*".
+ */
+static uint32_t sw_timer_calendar_parse(const char **expression, uint32_t min, uint32_t max, uint64_t *bits);
+
+/**
+ * @brief Returns number of days from 1970-01-01 to the date.
+ *
+ * @param year The year.
+ *
+ * @param month The month 1 - 12.
+ *
+ * @param day The day of month 1 - 31.
+ *
+ * @return The number of days.
+ */
+static uint32_t sw_timer_calendar_days_from_civil(uint32_t year, uint32_t month, uint32_t day);
+
+/**
+ * @brief Returns date of the number of days from 1970-01-01.
+ *
+ * @param days The number of days.
+ *
+ * @param year The pointer to year that need be filled.
+ *
+ * @param month The pointer to month that need be filled.
+ *
+ * @param day The pointer to day of month that need be filled.
+ */
+static void sw_timer_calendar_civil_from_days(uint32_t days, uint32_t *year, uint32_t *month, uint32_t *day);
+
+/**
+ * @brief Returns days of the month matching the schedule.
+ *
+ * @param calendar The pointer to schedule.
+ *
+ * @param year The year.
+ *
+ * @param month The month 1 - 12.
+ *
+ * @return The bitset of days 1 - 31.
+ */
+static uint32_t sw_timer_calendar_month_days(const sw_timer_calendar_t *calendar, uint32_t year, uint32_t month);
+
+/**
+ * @brief Returns index of the lowest set bit.
+ *
+ * @param value The value, not 0.
+ *
+ * @return The index.
+ */
+static uint32_t sw_timer_calendar_lowest_bit(uint64_t value);
+
+/**
+ * @brief Finds the first fire time after the time.
+ *
+ * @param calendar The pointer to schedule.
+ *
+ * @param now The time, in seconds.
+ *
+ * @param next The pointer to fire time that need be filled.
+ *
+ * @return Non-zero value if the fire time is found.
+ */
+static uint32_t sw_timer_calendar_find(const sw_timer_calendar_t *calendar, uint32_t now, uint32_t *next);
+
+/**
+ * @brief Wall-clock timer callback, fires the schedule if the fire time has
+ * come, otherwise finds the fire time again from the current wall time.
+ *
+ * @param arg The pointer to schedule.
+ */
+static void sw_timer_calendar_expired(void *arg);
+
+sw_timer_calendar_handle_t sw_timer_calendar_create(
+		const char *expression,
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		sw_timer_calendar_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_calendar_t) == sizeof(sw_timer_calendar_buffer_t));
+
+	sw_timer_calendar_t *calendar = (sw_timer_calendar_t *) buffer;
+	uint64_t bits[5];
+	uint32_t any[5];
+	uint32_t i;
+	static const uint8_t min[5] = { 0, 0, 1, 1, 0 };
+	static const uint8_t max[5] = { 59, 23, 31, 12, 7 };
+
+	if ((calendar == NULL) || (expression == NULL))
+		return NULL;
+
+	/* Minute, hour, day of month, month and day of week */
+	for (i = 0; i < 5; i++) {
+		any[i] = sw_timer_calendar_parse(&expression, min[i], max[i], &bits[i]);
+
+		if (any[i] == 0)
+			return NULL;
+	}
+
+	while (*expression == ' ')
+		expression++;
+
+	if (*expression != '\0')
+		return NULL;
+
+	sw_timer_wall_create((sw_timer_func_ptr_t) sw_timer_calendar_expired, calendar, &calendar->timer);
+
+	/* A clock step makes the schedule due at once to find the fire time
+	 * again */
+	sw_timer_wall_refind_on_step(&calendar->timer, 1);
+
+	calendar->callback = callback;
+	calendar->arg = arg;
+	calendar->minutes = bits[0];
+	calendar->hours = (uint32_t) bits[1];
+	calendar->days = (uint32_t) bits[2];
+	calendar->months = (uint32_t) bits[3];
+
+	/* Both 0 and 7 are Sunday */
+	calendar->weekdays = (uint32_t) ((bits[4] | (bits[4] >> 7)) & 0x7f);
+
+	calendar->flags = 0;
+	calendar->next = 0;
+
+	if (any[2] == 2)
+		calendar->flags |= SW_TIMER_CALENDAR_FLAG_ANY_DAY;
+
+	if (any[4] == 2)
+		calendar->flags |= SW_TIMER_CALENDAR_FLAG_ANY_WEEKDAY;
+
+	return calendar;
+}
+
+sw_timer_status_t sw_timer_calendar_start(sw_timer_calendar_handle_t handle)
+{
+	sw_timer_calendar_t *calendar = (sw_timer_calendar_t *) handle;
+	uint32_t now;
+
+	if (calendar == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (sw_timer_wall_now(&now) != SW_TIMER_STATUS_OK)
+		return SW_TIMER_STATUS_ERROR_CLOCK_NOT_REGISTERED;
+
+	if (!sw_timer_calendar_find(calendar, now, &calendar->next))
+		return SW_TIMER_STATUS_ERROR_SCHEDULE_NEVER_FIRES;
+
+	return sw_timer_wall_start_at(&calendar->timer, calendar->next, 0);
+}
+
+sw_timer_status_t sw_timer_calendar_stop(sw_timer_calendar_handle_t handle)
+{
+	sw_timer_calendar_t *calendar = (sw_timer_calendar_t *) handle;
+
+	if (calendar == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	return sw_timer_wall_stop(&calendar->timer);
+}
+
+uint32_t sw_timer_calendar_next(sw_timer_calendar_handle_t handle)
+{
+	return ((sw_timer_calendar_t *) handle)->next;
+}
+
+static uint32_t sw_timer_calendar_parse(const char **expression, uint32_t min, uint32_t max, uint64_t *bits)
+{
+	const char *p = *expression;
+	uint32_t any = 0;
+
+	*bits = 0;
+
+	while (*p == ' ')
+		p++;
+
+	for (;;) {
+		uint32_t first = min;
+		uint32_t last = max;
+		uint32_t step = 1;
+		uint32_t value;
+
+		if (*p == '*') {
+			p++;
+			any = 1;
+		} else if ((*p >= '0') && (*p <= '9')) {
+			for (first = 0; (*p >= '0') && (*p <= '9') && (first <= max); p++)
+				first = first * 10 + (uint32_t) (*p - '0');
+
+			last = first;
+
+			if (*p == '-') {
+				p++;
+
+				if ((*p < '0') || (*p > '9'))
+					return 0;
+
+				for (last = 0; (*p >= '0') && (*p <= '9') && (last <= max); p++)
+					last = last * 10 + (uint32_t) (*p - '0');
+			}
+		} else {
+			return 0;
+		}
+
+		/* A step after a single value runs to the maximum */
+		if (*p == '/') {
+			p++;
+
+			if ((*p < '0') || (*p > '9'))
+				return 0;
+
+			for (step = 0; (*p >= '0') && (*p <= '9') && (step <= max); p++)
+				step = step * 10 + (uint32_t) (*p - '0');
+
+			if (first == last)
+				last = max;
+		}
+
+		if ((first < min) || (last > max) || (first > last) || (step == 0))
+			return 0;
+
+		for (value = first; value <= last; value += step)
+			*bits |= (uint64_t) 1 << value;
+
+		if (*p != ',')
+			break;
+
+		p++;
+		any = 0;
+	}
+
+	if ((*p != ' ') && (*p != '\0'))
+		return 0;
+
+	*expression = p;
+
+	/* Only a single "*" makes the field unrestricted */
+	return ((any != 0) && (p[-1] == '*')) ? 2 : 1;
+}
+
+static uint32_t sw_timer_calendar_days_from_civil(uint32_t year, uint32_t month, uint32_t day)
+{
+	uint32_t era;
+	uint32_t year_of_era;
+	uint32_t day_of_year;
+	uint32_t day_of_era;
+
+	/* Years start in March, so the leap day is the last day of a year */
+	if (month <= 2)
+		year--;
+
+	era = year / 400;
+	year_of_era = year - era * 400;
+	day_of_year = (153 * ((month > 2) ? (month - 3) : (month + 9)) + 2) / 5 + day - 1;
+	day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+	/* 719468 is the number of days from 0000-03-01 to 1970-01-01 */
+	return era * 146097 + day_of_era - 719468;
+}
+
+static void sw_timer_calendar_civil_from_days(uint32_t days, uint32_t *year, uint32_t *month, uint32_t *day)
+{
+	uint32_t shifted = days + 719468;
+	uint32_t era = shifted / 146097;
+	uint32_t day_of_era = shifted - era * 146097;
+	uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	uint32_t march_month = (5 * day_of_year + 2) / 153;
+
+	*day = day_of_year - (153 * march_month + 2) / 5 + 1;
+	*month = (march_month < 10) ? (march_month + 3) : (march_month - 9);
+	*year = year_of_era + era * 400 + ((*month <= 2) ? 1 : 0);
+}
+
+static uint32_t sw_timer_calendar_month_days(const sw_timer_calendar_t *calendar, uint32_t year, uint32_t month)
+{
+	static const uint8_t lengths[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	uint32_t length = lengths[month - 1];
+	uint32_t valid;
+	uint32_t first_weekday;
+	uint32_t week;
+	uint32_t weekdays;
+
+	if ((month == 2) && ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0)))
+		length = 29;
+
+	valid = (uint32_t) ((((uint64_t) 1 << (length + 1)) - 1) & ~(uint64_t) 1);
+
+	if (calendar->flags & SW_TIMER_CALENDAR_FLAG_ANY_WEEKDAY)
+		return calendar->days & valid;
+
+	/* 1970-01-01 was Thursday, the week pattern is rotated to start at the
+	 * first day of the month and repeated over the month */
+	first_weekday = (sw_timer_calendar_days_from_civil(year, month, 1) + 4) % 7;
+	week = ((calendar->weekdays >> first_weekday) | (calendar->weekdays << (7 - first_weekday))) & 0x7f;
+	weekdays = ((week | (week << 7) | (week << 14) | (week << 21) | (week << 28)) << 1) & valid;
+
+	if (calendar->flags & SW_TIMER_CALENDAR_FLAG_ANY_DAY)
+		return weekdays;
+
+	/* Both fields restricted match either of them */
+	return (calendar->days & valid) | weekdays;
+}
+
+static uint32_t sw_timer_calendar_lowest_bit(uint64_t value)
+{
+#if defined(__GNUC__)
+	return (uint32_t) __builtin_ctzll(value);
+#else
+	uint32_t index = 0;
+
+	while ((value & 1) == 0) {
+		value >>= 1;
+		index++;
+	}
+
+	return index;
+#endif
+}
+
+static uint32_t sw_timer_calendar_find(const sw_timer_calendar_t *calendar, uint32_t now, uint32_t *next)
+{
+	uint32_t start = now - (now % 60) + 60;
+	uint32_t days = start / 86400;
+	uint32_t hour = (start % 86400) / 3600;
+	uint32_t minute = (start % 3600) / 60;
+	uint32_t steps;
+	uint32_t year;
+	uint32_t month;
+	uint32_t day;
+
+	sw_timer_calendar_civil_from_days(days, &year, &month, &day);
+
+	/* Every step moves to the next month, day or hour that could match, or
+	 * finds the fire time */
+	for (steps = 0; steps < SW_TIMER_CALENDAR_MAX_STEPS; steps++) {
+		uint32_t day_bits = 0;
+		uint32_t hour_bits;
+		uint64_t minute_bits;
+
+		if (calendar->months & ((uint32_t) 1 << month))
+			day_bits = sw_timer_calendar_month_days(calendar, year, month) & ~(uint32_t) (((uint64_t) 1 << day) - 1);
+
+		if (day_bits == 0) {
+			month = (month == 12) ? 1 : (month + 1);
+			year += (month == 1) ? 1 : 0;
+			day = 1;
+			hour = 0;
+			minute = 0;
+
+			continue;
+		}
+
+		if (sw_timer_calendar_lowest_bit(day_bits) != day) {
+			day = sw_timer_calendar_lowest_bit(day_bits);
+			hour = 0;
+			minute = 0;
+		}
+
+		hour_bits = (hour < 24) ? (calendar->hours & ~(((uint32_t) 1 << hour) - 1)) : 0;
+
+		if (hour_bits == 0) {
+			day++;
+			hour = 0;
+			minute = 0;
+
+			continue;
+		}
+
+		if (sw_timer_calendar_lowest_bit(hour_bits) != hour) {
+			hour = sw_timer_calendar_lowest_bit(hour_bits);
+			minute = 0;
+		}
+
+		minute_bits = calendar->minutes & ~(((uint64_t) 1 << minute) - 1);
+
+		if (minute_bits == 0) {
+			hour++;
+			minute = 0;
+
+			continue;
+		}
+
+		minute = sw_timer_calendar_lowest_bit(minute_bits);
+
+		/* Times after 2106-02-07 do not fit the clock */
+		days = sw_timer_calendar_days_from_civil(year, month, day);
+
+		if (days >= 0xffffffff / 86400)
+			return 0;
+
+		*next = days * 86400 + hour * 3600 + minute * 60;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+static void sw_timer_calendar_expired(void *arg)
+{
+	sw_timer_calendar_t *calendar = (sw_timer_calendar_t *) arg;
+	void (*callback)(void *arg) = calendar->callback;
+	uint32_t now;
+
+	sw_timer_wall_now(&now);
+
+	/* A clock step makes the schedule due at once, a fire time not reached
+	 * yet is found again from the new wall time */
+	if ((int32_t) (calendar->next - now) > 0) {
+		if (sw_timer_calendar_find(calendar, now, &calendar->next))
+			sw_timer_wall_start_at(&calendar->timer, calendar->next, 0);
+
+		return;
+	}
+
+	/* The next fire time is armed before the callback, so the callback can
+	 * stop the schedule */
+	if (sw_timer_calendar_find(calendar, now, &calendar->next))
+		sw_timer_wall_start_at(&calendar->timer, calendar->next, 0);
+
+	if (callback != NULL)
+		callback(calendar->arg);
+}
+
+#endif /* SW_TIMER_CALENDAR > 0 */
@@ -0,0 +1,200 @@
+#include "sw_timer.h"
+
+#if SW_TIMER_CYCLIC_TASKS > 0
+
+#if (SW_TIMER_CYCLIC_TASKS > 256) || (SW_TIMER_CYCLIC_ENTRIES > 65535)
+#error "SW_TIMER_CYCLIC_TASKS must not exceed 256 and SW_TIMER_CYCLIC_ENTRIES 65535"
+#endif
+
+/**
+ * @brief The task set the schedule is built from.
+ */
+static const sw_timer_cyclic_task_t *tasks = NULL;
+
+/**
+ * @brief Index of the first table entry of every frame, the last element
+ * is the number of entries.
+ */
+static uint16_t frame_starts[SW_TIMER_CYCLIC_FRAMES + 1];
+
+/**
+ * @brief Table entries, task indexes of all frames one after another.
+ */
+static uint8_t entries[SW_TIMER_CYCLIC_ENTRIES];
+
+/**
+ * @brief Number of frames in the hyperperiod.
+ */
+static uint32_t frames = 0;
+
+/**
+ * @brief The next frame to be dispatched.
+ */
+static uint32_t frame = 0;
+
+/**
+ * @brief Frame length in ticks.
+ */
+static uint32_t minor_cycle = 0;
+
+/**
+ * @brief Timer buffer of the frame timer.
+ */
+static sw_timer_buffer_t frame_timer_buffer;
+
+/**
+ * @brief The frame timer.
+ */
+static sw_timer_handle_t frame_timer = NULL;
+
+/**
+ * @brief Returns the greatest common divisor.
+ *
+ * @param a The first value.
+ *
+ * @param b The second value.
+ *
+ * @return The greatest common divisor, the other value if one value is 0.
+ */
+static uint32_t sw_timer_cyclic_gcd(uint32_t a, uint32_t b);
+
+/**
+ * @brief Frame timer callback, dispatches the next frame of the schedule.
+ *
+ * @param arg Not used.
+ */
+static void sw_timer_cyclic_dispatch(void *arg);
+
+sw_timer_status_t sw_timer_cyclic_init(const sw_timer_cyclic_task_t *task_set, uint32_t count)
+{
+	uint32_t hyperperiod = 1;
+	uint32_t minor = 0;
+	uint32_t used = 0;
+	uint32_t f;
+	uint32_t i;
+
+	if ((task_set == NULL) || (count == 0))
+		return SW_TIMER_STATUS_ERROR_INVALID_ARGUMENT;
+
+	if (count > SW_TIMER_CYCLIC_TASKS)
+		return SW_TIMER_STATUS_ERROR_SCHEDULE_TOO_LARGE;
+
+	/* Frames are as long as the greatest common divisor of all periods and
+	 * offsets, so every release is at a frame start */
+	for (i = 0; i < count; i++) {
+		uint32_t period = task_set[i].period;
+
+		if ((period == 0) || (task_set[i].offset >= period))
+			return SW_TIMER_STATUS_ERROR_INVALID_ARGUMENT;
+
+		minor = sw_timer_cyclic_gcd(minor, sw_timer_cyclic_gcd(period, task_set[i].offset));
+	}
+
+	/* Hyperperiod in frames is the least common multiple of all periods in
+	 * frames, harmonic periods give the longest one */
+	for (i = 0; i < count; i++) {
+		uint32_t frame_period = task_set[i].period / minor;
+		uint32_t factor = frame_period / sw_timer_cyclic_gcd(hyperperiod, frame_period);
+
+		if (hyperperiod > SW_TIMER_CYCLIC_FRAMES / factor)
+			return SW_TIMER_STATUS_ERROR_SCHEDULE_TOO_LARGE;
+
+		hyperperiod *= factor;
+	}
+
+	/* Every task is released hyperperiod / frame period times, the table is
+	 * checked before it is touched so a failure keeps the running schedule */
+	for (i = 0; i < count; i++)
+		used += hyperperiod / (task_set[i].period / minor);
+
+	if (used > SW_TIMER_CYCLIC_ENTRIES)
+		return SW_TIMER_STATUS_ERROR_SCHEDULE_TOO_LARGE;
+
+	if (frame_timer != NULL)
+		sw_timer_stop(frame_timer);
+
+	used = 0;
+
+	for (f = 0; f < hyperperiod; f++) {
+		frame_starts[f] = (uint16_t) used;
+
+		for (i = 0; i < count; i++) {
+			uint32_t frame_period = task_set[i].period / minor;
+
+			if ((f % frame_period) == (task_set[i].offset / minor))
+				entries[used++] = (uint8_t) i;
+		}
+	}
+
+	frame_starts[hyperperiod] = (uint16_t) used;
+
+	tasks = task_set;
+	frames = hyperperiod;
+	frame = 0;
+	minor_cycle = minor;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_status_t sw_timer_cyclic_start(void)
+{
+	if (frames == 0)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (frame_timer == NULL)
+		frame_timer = sw_timer_create(minor_cycle, SW_TIMER_MODE_REPEATING,
+				sw_timer_cyclic_dispatch, NULL, &frame_timer_buffer);
+	else
+		sw_timer_update(frame_timer, minor_cycle, SW_TIMER_MODE_REPEATING,
+				sw_timer_cyclic_dispatch, NULL);
+
+	/* The first frame is dispatched at the first expiry, one frame length
+	 * after the start */
+	frame = 0;
+
+	return sw_timer_start(frame_timer);
+}
+
+sw_timer_status_t sw_timer_cyclic_stop(void)
+{
+	return sw_timer_stop(frame_timer);
+}
+
+uint32_t sw_timer_cyclic_minor_cycle(void)
+{
+	return minor_cycle;
+}
+
+static void sw_timer_cyclic_dispatch(void *arg)
+{
+	uint32_t i;
+
+	(void) arg;
+
+	if (frames == 0)
+		return;
+
+	for (i = frame_starts[frame]; i < frame_starts[frame + 1]; i++) {
+		const sw_timer_cyclic_task_t *task = &tasks[entries[i]];
+		void (*callback)(void *arg) = task->callback;
+
+		if (callback != NULL)
+			callback(task->arg);
+	}
+
+	frame = (frame + 1 != frames) ? (frame + 1) : 0;
+}
+
+static uint32_t sw_timer_cyclic_gcd(uint32_t a, uint32_t b)
+{
+	while (b != 0) {
+		uint32_t r = a % b;
+
+		a = b;
+		b = r;
+	}
+
+	return a;
+}
+
+#endif /* SW_TIMER_CYCLIC_TASKS > 0 */
@@ -0,0 +1,254 @@
+#include <assert.h>
+
+#include "sw_timer.h"
+
+/**
+ * @brief Deadline flag set while the deadline is started.
+ */
+#define SW_TIMER_DEADLINE_FLAG_RUNNING 0x00000001
+
+/**
+ * @brief Deadline flag set while the deadline has its own timer started.
+ */
+#define SW_TIMER_DEADLINE_FLAG_ARMED 0x00000002
+
+/**
+ * @brief Deadline flag set while the callback of expired deadline is not
+ * called yet.
+ */
+#define SW_TIMER_DEADLINE_FLAG_PENDING 0x00000004
+
+/**
+ * @brief Deadline type.
+ */
+typedef struct SW_TIMER_DEADLINE
+{
+	// A timer started only if the deadline is earlier than parent one
+	sw_timer_buffer_t timer;
+
+	// A pointer to the parent deadline
+	struct SW_TIMER_DEADLINE *parent;
+
+	// A pointer to the first child deadline
+	struct SW_TIMER_DEADLINE *child;
+
+	// A pointer to the next sibling deadline
+	struct SW_TIMER_DEADLINE *next;
+
+	// A pointer to the previous sibling deadline
+	struct SW_TIMER_DEADLINE *prev;
+
+	// A pointer to the next expired deadline waiting for callback
+	struct SW_TIMER_DEADLINE *pending;
+
+	// A pointer to the callback function
+	sw_timer_func_ptr_t callback;
+
+	// A pointer to the callback argument
+	sw_timer_arg_ptr_t arg;
+
+	// A deadline state flags
+	uint32_t flags;
+} sw_timer_deadline_t;
+
+/**
+ * @brief Stops the deadline and all its descendants.
+ *
+ * Descendants are stopped before their parents, expired deadlines are
+ * linked to the pending list in the same order.
+ *
+ * @param deadline The pointer to started deadline.
+ *
+ * @param pending The pointer to the pending list head, NULL if the deadline
+ * is cancelled.
+ */
+static void sw_timer_deadline_detach(sw_timer_deadline_t *deadline, sw_timer_deadline_t **pending);
+
+/**
+ * @brief Timer callback of deadlines that have their own timer.
+ *
+ * @param arg The pointer to expired deadline.
+ */
+static void sw_timer_deadline_expired(void *arg);
+
+sw_timer_deadline_handle_t sw_timer_deadline_create(
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		sw_timer_deadline_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_deadline_t) == sizeof(sw_timer_deadline_buffer_t));
+
+	sw_timer_deadline_t *deadline = (sw_timer_deadline_t *) buffer;
+
+	sw_timer_create(0, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) sw_timer_deadline_expired, deadline, &deadline->timer);
+
+	deadline->parent = NULL;
+	deadline->child = NULL;
+	deadline->next = NULL;
+	deadline->prev = NULL;
+	deadline->pending = NULL;
+
+	deadline->callback = callback;
+	deadline->arg = arg;
+	deadline->flags = 0;
+
+	return deadline;
+}
+
+sw_timer_status_t sw_timer_deadline_start(
+		sw_timer_deadline_handle_t handle,
+		sw_timer_deadline_handle_t parent_handle,
+		uint32_t delay)
+{
+	sw_timer_deadline_t *deadline = (sw_timer_deadline_t *) handle;
+	sw_timer_deadline_t *parent = (sw_timer_deadline_t *) parent_handle;
+	sw_timer_deadline_t *owner;
+	sw_timer_status_t status = SW_TIMER_STATUS_OK;
+
+	if (deadline == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	/* Restart already started deadline */
+	if (deadline->flags & SW_TIMER_DEADLINE_FLAG_RUNNING)
+		sw_timer_deadline_detach(deadline, NULL);
+
+	/* The callback of the previous expiry is not called any more */
+	deadline->flags = 0;
+
+	if ((parent != NULL) && ((parent->flags & SW_TIMER_DEADLINE_FLAG_RUNNING) == 0))
+		return SW_TIMER_STATUS_ERROR_PARENT_NOT_RUNNING;
+
+	/* The nearest ancestor with its own timer limits the deadline */
+	owner = parent;
+
+	while ((owner != NULL) && ((owner->flags & SW_TIMER_DEADLINE_FLAG_ARMED) == 0))
+		owner = owner->parent;
+
+	if ((owner == NULL) || (delay < sw_timer_remaining(&owner->timer))) {
+		sw_timer_update(&deadline->timer, delay, SW_TIMER_MODE_SINGLE_SHOT,
+				(sw_timer_func_ptr_t) sw_timer_deadline_expired, deadline);
+
+		status = sw_timer_start(&deadline->timer);
+
+		if (status != SW_TIMER_STATUS_OK)
+			return status;
+
+		deadline->flags |= SW_TIMER_DEADLINE_FLAG_ARMED;
+	}
+
+	deadline->parent = parent;
+	deadline->prev = NULL;
+
+	if (parent != NULL) {
+		deadline->next = parent->child;
+
+		if (parent->child != NULL)
+			parent->child->prev = deadline;
+
+		parent->child = deadline;
+	}
+
+	deadline->flags |= SW_TIMER_DEADLINE_FLAG_RUNNING;
+
+	return status;
+}
+
+sw_timer_status_t sw_timer_deadline_cancel(sw_timer_deadline_handle_t handle)
+{
+	sw_timer_deadline_t *deadline = (sw_timer_deadline_t *) handle;
+
+	if (deadline == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (deadline->flags & SW_TIMER_DEADLINE_FLAG_RUNNING)
+		sw_timer_deadline_detach(deadline, NULL);
+
+	/* The callback of the previous expiry is not called any more */
+	deadline->flags = 0;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+static void sw_timer_deadline_detach(sw_timer_deadline_t *deadline, sw_timer_deadline_t **pending)
+{
+	sw_timer_deadline_t *node = deadline;
+
+	/* Unlink the subtree from the parent */
+	if (deadline->prev != NULL)
+		deadline->prev->next = deadline->next;
+	else if (deadline->parent != NULL)
+		deadline->parent->child = deadline->next;
+
+	if (deadline->next != NULL)
+		deadline->next->prev = deadline->prev;
+
+	deadline->parent = NULL;
+	deadline->next = NULL;
+	deadline->prev = NULL;
+
+	/* Post-order walk, the first child is always removed, so the walk needs
+	 * no stack */
+	for (;;) {
+		sw_timer_deadline_t *parent;
+
+		while (node->child != NULL)
+			node = node->child;
+
+		parent = node->parent;
+
+		if (parent != NULL) {
+			parent->child = node->next;
+
+			if (node->next != NULL)
+				node->next->prev = NULL;
+		}
+
+		if (node->flags & SW_TIMER_DEADLINE_FLAG_ARMED)
+			sw_timer_stop(&node->timer);
+
+		node->parent = NULL;
+		node->next = NULL;
+		node->prev = NULL;
+
+		if (pending != NULL) {
+			node->flags = SW_TIMER_DEADLINE_FLAG_PENDING;
+
+			node->pending = NULL;
+			*pending = node;
+			pending = &node->pending;
+		} else {
+			node->flags = 0;
+		}
+
+		if (node == deadline)
+			break;
+
+		node = parent;
+	}
+}
+
+static void sw_timer_deadline_expired(void *arg)
+{
+	sw_timer_deadline_t *deadline = (sw_timer_deadline_t *) arg;
+	sw_timer_deadline_t *pending = NULL;
+
+	sw_timer_deadline_detach(deadline, &pending);
+
+	/* Callbacks are called after the whole subtree is stopped, a callback
+	 * could restart or cancel other expired deadlines */
+	while (pending != NULL) {
+		sw_timer_deadline_t *node = pending;
+
+		pending = node->pending;
+		node->pending = NULL;
+
+		if (node->flags & SW_TIMER_DEADLINE_FLAG_PENDING) {
+			void (*callback)(void* arg) = node->callback;
+
+			node->flags &= ~SW_TIMER_DEADLINE_FLAG_PENDING;
+
+			if (callback != NULL)
+				callback(node->arg);
+		}
+	}
+}
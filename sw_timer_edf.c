@@ -0,0 +1,355 @@
+#include <assert.h>
+
+#include "sw_timer.h"
+
+#if SW_TIMER_EDF_TASKS > 0
+
+/**
+ * @brief Task state when the task is neither sleeping nor ready.
+ */
+#define SW_TIMER_EDF_STATE_IDLE 0
+
+/**
+ * @brief Task state while the release timer is running.
+ */
+#define SW_TIMER_EDF_STATE_SLEEPING 1
+
+/**
+ * @brief Task state while the task is in the ready queue.
+ */
+#define SW_TIMER_EDF_STATE_READY 2
+
+/**
+ * @brief Period of the clock timer, it only keeps the time running.
+ */
+#define SW_TIMER_EDF_CLOCK_PERIOD 0x40000000
+
+/**
+ * @brief EDF task type.
+ */
+typedef struct SW_TIMER_EDF_TASK
+{
+	// A release timer
+	sw_timer_buffer_t timer;
+
+	// A pointer to the task function
+	sw_timer_func_ptr_t callback;
+
+	// A pointer to the task function argument
+	sw_timer_arg_ptr_t arg;
+
+	// A deadline relative to the release, in ticks
+	uint32_t relative_deadline;
+
+	// An absolute deadline of the released job
+	uint32_t deadline;
+
+	// An absolute deadline of the job taken by sw_timer_edf_next()
+	uint32_t job_deadline;
+
+	// An index in the ready queue
+	uint32_t index;
+
+	// A number of jobs completed after their deadline
+	uint32_t misses;
+
+	// Non-zero while the job taken by sw_timer_edf_next() is not completed
+	uint32_t taken;
+
+	// A task state
+	uint32_t state;
+} sw_timer_edf_task_t;
+
+/**
+ * @brief Ready queue, binary min-heap ordered by absolute deadline.
+ */
+static sw_timer_edf_task_t *ready[SW_TIMER_EDF_TASKS];
+
+/**
+ * @brief Number of created tasks, every one of them fits the ready queue.
+ */
+static uint32_t task_count = 0;
+
+/**
+ * @brief Number of ready tasks.
+ */
+static uint32_t ready_count = 0;
+
+/**
+ * @brief Number of taken jobs not completed yet.
+ */
+static uint32_t taken_count = 0;
+
+/**
+ * @brief Number of jobs completed after their deadline by all tasks.
+ */
+static uint32_t total_misses = 0;
+
+/**
+ * @brief Timer buffer of the clock timer.
+ */
+static sw_timer_buffer_t clock_timer_buffer;
+
+/**
+ * @brief The clock timer, it runs while jobs are ready or taken, so
+ * sw_timer_now() does not stand still before they complete.
+ */
+static sw_timer_handle_t clock_timer = NULL;
+
+/**
+ * @brief Release timer callback, puts the task to the ready queue instead of
+ * running it.
+ *
+ * @param task The pointer to task.
+ */
+static void sw_timer_edf_release(sw_timer_edf_task_t *task);
+
+/**
+ * @brief Compares task deadlines.
+ *
+ * @param a The pointer to the first task.
+ *
+ * @param b The pointer to the second task.
+ *
+ * @return Non-zero value if the first task deadline is earlier.
+ */
+static int sw_timer_edf_earlier(const sw_timer_edf_task_t *a, const sw_timer_edf_task_t *b);
+
+/**
+ * @brief Places task to the ready queue index.
+ *
+ * @param task The pointer to task.
+ *
+ * @param index The index.
+ */
+static void sw_timer_edf_place(sw_timer_edf_task_t *task, uint32_t index);
+
+/**
+ * @brief Moves task up or down from its index to restore the heap order.
+ *
+ * @param task The pointer to task in the ready queue.
+ */
+static void sw_timer_edf_sift(sw_timer_edf_task_t *task);
+
+/**
+ * @brief Removes task from the ready queue.
+ *
+ * @param task The pointer to task in the ready queue.
+ */
+static void sw_timer_edf_unlink(sw_timer_edf_task_t *task);
+
+/**
+ * @brief Starts the clock timer if jobs are ready or taken, stops it
+ * otherwise.
+ */
+static void sw_timer_edf_clock(void);
+
+sw_timer_edf_handle_t sw_timer_edf_create(
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		uint32_t relative_deadline,
+		sw_timer_edf_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_edf_task_t) == sizeof(sw_timer_edf_buffer_t));
+
+	sw_timer_edf_task_t *task = (sw_timer_edf_task_t *) buffer;
+
+	if (task_count == SW_TIMER_EDF_TASKS)
+		return NULL;
+
+	task_count++;
+
+	if (clock_timer == NULL)
+		clock_timer = sw_timer_create(SW_TIMER_EDF_CLOCK_PERIOD, SW_TIMER_MODE_REPEATING, NULL, NULL, &clock_timer_buffer);
+
+	sw_timer_create(0, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) sw_timer_edf_release, task, &task->timer);
+
+	task->callback = callback;
+	task->arg = arg;
+	task->relative_deadline = relative_deadline;
+	task->deadline = 0;
+	task->job_deadline = 0;
+	task->index = 0;
+	task->misses = 0;
+	task->taken = 0;
+	task->state = SW_TIMER_EDF_STATE_IDLE;
+
+	return task;
+}
+
+sw_timer_status_t sw_timer_edf_release_after(sw_timer_edf_handle_t handle, uint32_t delay)
+{
+	sw_timer_edf_task_t *task = (sw_timer_edf_task_t *) handle;
+
+	if (task == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	sw_timer_edf_cancel(task);
+
+	if (delay == 0) {
+		sw_timer_edf_release(task);
+
+		return SW_TIMER_STATUS_OK;
+	}
+
+	task->state = SW_TIMER_EDF_STATE_SLEEPING;
+
+	return sw_timer_reschedule(&task->timer, delay);
+}
+
+sw_timer_status_t sw_timer_edf_cancel(sw_timer_edf_handle_t handle)
+{
+	sw_timer_edf_task_t *task = (sw_timer_edf_task_t *) handle;
+
+	if (task == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (task->state == SW_TIMER_EDF_STATE_SLEEPING)
+		sw_timer_stop(&task->timer);
+	else if (task->state == SW_TIMER_EDF_STATE_READY)
+		sw_timer_edf_unlink(task);
+
+	task->state = SW_TIMER_EDF_STATE_IDLE;
+
+	sw_timer_edf_clock();
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_edf_handle_t sw_timer_edf_next(void)
+{
+	sw_timer_edf_task_t *task;
+
+	if (ready_count == 0)
+		return NULL;
+
+	task = ready[0];
+
+	sw_timer_edf_unlink(task);
+
+	task->state = SW_TIMER_EDF_STATE_IDLE;
+	task->job_deadline = task->deadline;
+
+	if (task->taken == 0) {
+		task->taken = 1;
+		taken_count++;
+	}
+
+	return task;
+}
+
+void sw_timer_edf_run(sw_timer_edf_handle_t handle)
+{
+	sw_timer_edf_task_t *task = (sw_timer_edf_task_t *) handle;
+	void (*callback)(void *arg) = task->callback;
+
+	if (callback != NULL)
+		callback(task->arg);
+}
+
+sw_timer_status_t sw_timer_edf_complete(sw_timer_edf_handle_t handle)
+{
+	sw_timer_edf_task_t *task = (sw_timer_edf_task_t *) handle;
+
+	if (task == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if ((int32_t) (sw_timer_now() - task->job_deadline) > 0) {
+		task->misses++;
+		total_misses++;
+	}
+
+	if (task->taken != 0) {
+		task->taken = 0;
+		taken_count--;
+
+		sw_timer_edf_clock();
+	}
+
+	return SW_TIMER_STATUS_OK;
+}
+
+uint32_t sw_timer_edf_misses(sw_timer_edf_handle_t handle)
+{
+	if (handle == NULL)
+		return total_misses;
+
+	return ((sw_timer_edf_task_t *) handle)->misses;
+}
+
+static void sw_timer_edf_release(sw_timer_edf_task_t *task)
+{
+	/* Every created task is either sleeping or ready only once, so the queue
+	 * cannot overflow */
+	assert(ready_count < SW_TIMER_EDF_TASKS);
+
+	task->deadline = sw_timer_now() + task->relative_deadline;
+	task->state = SW_TIMER_EDF_STATE_READY;
+
+	sw_timer_edf_place(task, ready_count++);
+	sw_timer_edf_sift(task);
+
+	sw_timer_edf_clock();
+}
+
+static int sw_timer_edf_earlier(const sw_timer_edf_task_t *a, const sw_timer_edf_task_t *b)
+{
+	return (int32_t) (a->deadline - b->deadline) < 0;
+}
+
+static void sw_timer_edf_place(sw_timer_edf_task_t *task, uint32_t index)
+{
+	ready[index] = task;
+	task->index = index;
+}
+
+static void sw_timer_edf_sift(sw_timer_edf_task_t *task)
+{
+	uint32_t index = task->index;
+
+	while ((index > 0) && sw_timer_edf_earlier(task, ready[(index - 1) / 2])) {
+		sw_timer_edf_place(ready[(index - 1) / 2], index);
+
+		index = (index - 1) / 2;
+	}
+
+	for (;;) {
+		uint32_t child = 2 * index + 1;
+
+		if (child >= ready_count)
+			break;
+
+		if ((child + 1 < ready_count) && sw_timer_edf_earlier(ready[child + 1], ready[child]))
+			child++;
+
+		if (!sw_timer_edf_earlier(ready[child], task))
+			break;
+
+		sw_timer_edf_place(ready[child], index);
+
+		index = child;
+	}
+
+	sw_timer_edf_place(task, index);
+}
+
+static void sw_timer_edf_unlink(sw_timer_edf_task_t *task)
+{
+	sw_timer_edf_task_t *last = ready[--ready_count];
+
+	/* The last task fills the hole and is moved to its place */
+	if (last != task) {
+		sw_timer_edf_place(last, task->index);
+		sw_timer_edf_sift(last);
+	}
+}
+
+static void sw_timer_edf_clock(void)
+{
+	if ((ready_count + taken_count) == 0)
+		sw_timer_stop(clock_timer);
+	else if (!sw_timer_is_running(clock_timer))
+		sw_timer_start(clock_timer);
+}
+
+#endif /* SW_TIMER_EDF_TASKS > 0 */
@@ -0,0 +1,397 @@
+#ifndef SW_TIMER_ENGINE_H
+#define SW_TIMER_ENGINE_H
+
+#include "sw_timer.h"
+
+/**
+ * @brief Software timer engine private interface.
+ *
+ * The engine is the data structure that keeps running timers ordered by
+ * expiry time. Exactly one engine is compiled in, selected by the
+ * SW_TIMER_ENGINE macro. The engine only orders timers, all physical timer
+ * handling and expiry time bookkeeping are done by sw_timer.c.
+ *
+ * This header is not part of the public API and must not be included by
+ * application code.
+ */
+
+struct SW_TIMER;
+
+/**
+ * @brief Timer flag set while the timer is started.
+ */
+#define SW_TIMER_FLAG_RUNNING 0x00000001
+
+/**
+ * @brief Timer flag set if expiries are pushed to the expiry ring instead
+ * of calling the callback.
+ */
+#define SW_TIMER_FLAG_RING 0x00000002
+
+/**
+ * @brief Full memory barrier between the interrupt handler and threads,
+ * not defined if the compiler provides none. Could be defined by
+ * application developer for other compilers.
+ */
+#ifndef SW_TIMER_BARRIER
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define SW_TIMER_BARRIER() atomic_thread_fence(memory_order_seq_cst)
+#elif defined(__GNUC__)
+#define SW_TIMER_BARRIER() __sync_synchronize()
+#endif
+#endif
+
+/**
+ * @brief The time all expiry times are ordered from.
+ *
+ * Timers keep absolute expiry time, that wraps around. Expiry time relative
+ * to the epoch is the key engines order timers by, it is less than
+ * 0x80000000 for all running timers.
+ */
+extern uint32_t sw_timer_epoch;
+
+/**
+ * @brief Returns expiry time relative to the epoch.
+ */
+#define SW_TIMER_ENGINE_KEY(time) ((uint32_t) ((time) - sw_timer_epoch))
+
+/**
+ * @brief Intrusive heap node type, used by heap based engines.
+ */
+typedef struct SW_TIMER_HEAP_NODE
+{
+	// A pointer to the left child node
+	struct SW_TIMER_HEAP_NODE *left;
+
+	// A pointer to the right child node
+	struct SW_TIMER_HEAP_NODE *right;
+
+	// A pointer to the parent node
+	struct SW_TIMER_HEAP_NODE *parent;
+} sw_timer_heap_node_t;
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_LIST
+
+/**
+ * @brief Linked list engine node type.
+ */
+typedef struct SW_TIMER_ENGINE_NODE
+{
+	// A pointer to the next node
+	struct SW_TIMER *next;
+
+	// A pointer to the previous node
+	struct SW_TIMER *prev;
+} sw_timer_engine_node_t;
+
+#elif SW_TIMER_ENGINE == SW_TIMER_ENGINE_FIFO
+
+struct SW_TIMER_FIFO;
+
+/**
+ * @brief Per-period FIFO engine node type.
+ */
+typedef struct SW_TIMER_ENGINE_NODE
+{
+	// A pointer to the next node in the FIFO
+	struct SW_TIMER *next;
+
+	// A pointer to the previous node in the FIFO
+	struct SW_TIMER *prev;
+
+	// A pointer to the FIFO the node is queued in
+	struct SW_TIMER_FIFO *fifo;
+} sw_timer_engine_node_t;
+
+#elif SW_TIMER_ENGINE == SW_TIMER_ENGINE_RADIX
+
+/**
+ * @brief Radix heap engine node type.
+ */
+typedef struct SW_TIMER_ENGINE_NODE
+{
+	// A pointer to the next node in the bucket
+	struct SW_TIMER *next;
+
+	// A pointer to the previous node in the bucket
+	struct SW_TIMER *prev;
+
+	// A pointer to the bucket the node is linked to
+	struct SW_TIMER **bucket;
+} sw_timer_engine_node_t;
+
+#elif SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID
+
+/**
+ * @brief Hybrid engine node type.
+ */
+typedef struct SW_TIMER_ENGINE_NODE
+{
+	union
+	{
+		// A heap links
+		sw_timer_heap_node_t heap;
+
+		// A timing wheel slot links
+		struct
+		{
+			// A pointer to the next node in the slot
+			struct SW_TIMER *next;
+
+			// A pointer to the previous node in the slot
+			struct SW_TIMER *prev;
+		} wheel;
+	} link;
+
+	// A pointer to the wheel slot the node is linked to, NULL for heap
+	struct SW_TIMER **slot;
+} sw_timer_engine_node_t;
+
+#define SW_TIMER_ENGINE_HEAP_NODE node.link.heap
+
+#elif SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE
+
+/**
+ * @brief Adaptive engine node type.
+ */
+typedef struct SW_TIMER_ENGINE_NODE
+{
+	// A pointer to the next node in the list mode
+	struct SW_TIMER *next;
+
+	// A pointer to the previous node in the list mode
+	struct SW_TIMER *prev;
+
+	// A heap links in the heap mode
+	sw_timer_heap_node_t heap;
+} sw_timer_engine_node_t;
+
+#define SW_TIMER_ENGINE_HEAP_NODE node.heap
+
+#else
+#error "Unknown SW_TIMER_ENGINE"
+#endif
+
+/**
+ * @brief Software timer type.
+ *
+ */
+typedef struct SW_TIMER
+{
+	// A timer expiry time
+	uint32_t time;
+
+	// A timer period
+	uint32_t period;
+
+	// A timer mode of operations
+	uint32_t mode;
+
+	// A timer state flags
+	uint32_t flags;
+
+	// A number of expiries, the word sw_timer_wait() waits on
+	volatile uint32_t expiries;
+
+	// Non-zero value if sw_timer_wait() could wait for the timer
+	volatile uint8_t waiting;
+
+	// Non-zero value if sw_timer_wait_any() could wait for the timer
+	volatile uint8_t group_waiting;
+
+	// A pointer to the callback function
+	sw_timer_func_ptr_t callback;
+
+	// A pointer to the callback argument
+	sw_timer_arg_ptr_t arg;
+
+	// An engine specific links
+	sw_timer_engine_node_t node;
+} sw_timer_t;
+
+/**
+ * @brief Inserts timer to the engine.
+ *
+ * @param timer The pointer to timer with already calculated expiry time.
+ */
+void sw_timer_engine_insert(sw_timer_t *timer);
+
+/**
+ * @brief Removes timer from the engine.
+ *
+ * The engine must not rely on the expiry time of the removed timer,
+ * the time could be already changed by the caller.
+ *
+ * @param timer The pointer to timer that was previously inserted.
+ */
+void sw_timer_engine_remove(sw_timer_t *timer);
+
+/**
+ * @brief Returns timer with the earliest expiry time.
+ *
+ * @return The pointer to timer or NULL if there are no running timers.
+ */
+sw_timer_t *sw_timer_engine_peek(void);
+
+/**
+ * @brief Informs engine that the epoch was moved forward.
+ *
+ * Keys of all running timers became less by the shift time. Engines that
+ * compare keys only have nothing to do, engines that keep keys in their own
+ * structures update them.
+ *
+ * @param shift_time The time the epoch was moved by.
+ */
+void sw_timer_engine_shift(uint32_t shift_time);
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID
+
+/**
+ * @brief Removes expired timer from the engine.
+ *
+ * Engines that learn from timer expiry and cancellation implement this
+ * function, for other engines it is the same as sw_timer_engine_remove().
+ *
+ * @param timer The pointer to timer that was previously inserted.
+ */
+void sw_timer_engine_expire(sw_timer_t *timer);
+
+#else
+#define sw_timer_engine_expire(timer) sw_timer_engine_remove(timer)
+#endif
+
+#if (SW_TIMER_ENGINE == SW_TIMER_ENGINE_LIST) || (SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID) \
+		|| (SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE)
+
+/**
+ * @brief Moves inserted timer after its expiry time was changed.
+ *
+ * Engines that can reposition a node from its current place implement this
+ * function, for other engines it is removing and inserting the timer again.
+ *
+ * @param timer The pointer to timer that was previously inserted.
+ */
+void sw_timer_engine_move(sw_timer_t *timer);
+
+#else
+#define sw_timer_engine_move(timer) do { sw_timer_engine_remove(timer); sw_timer_engine_insert(timer); } while (0)
+#endif
+
+#if (SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID) || (SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE)
+
+/**
+ * @brief Fills engine specific statistics.
+ *
+ * @param stats The pointer to statistics.
+ */
+void sw_timer_engine_get_stats(sw_timer_stats_t *stats);
+
+#else
+#define sw_timer_engine_get_stats(stats) ((void) (stats))
+#endif
+
+#if (SW_TIMER_ENGINE == SW_TIMER_ENGINE_LIST) || (SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE)
+
+/**
+ * @brief Inserts timer to doubly linked list sorted by expiry time, shared
+ * by the list engine and the list mode of the adaptive engine. Timers with
+ * equal time keep start order.
+ *
+ * @param head The pointer to the list head.
+ *
+ * @param new_timer The pointer to timer with already calculated expiry time.
+ *
+ * @return Number of list nodes passed before the insert position.
+ */
+static inline uint32_t sw_timer_engine_list_insert(sw_timer_t **head, sw_timer_t *new_timer)
+{
+	sw_timer_t **link = head;
+	sw_timer_t *prev = NULL;
+	uint32_t steps = 0;
+
+	while ((*link != NULL) && (SW_TIMER_ENGINE_KEY((*link)->time) <= SW_TIMER_ENGINE_KEY(new_timer->time))) {
+		prev = *link;
+		link = &prev->node.next;
+
+		steps++;
+	}
+
+	new_timer->node.prev = prev;
+	new_timer->node.next = *link;
+
+	if (*link != NULL)
+		(*link)->node.prev = new_timer;
+
+	*link = new_timer;
+
+	return steps;
+}
+
+/**
+ * @brief Removes timer from doubly linked list.
+ *
+ * @param head The pointer to the list head.
+ *
+ * @param timer The pointer to timer in the list.
+ */
+static inline void sw_timer_engine_list_remove(sw_timer_t **head, sw_timer_t *timer)
+{
+	if (timer->node.prev != NULL)
+		timer->node.prev->node.next = timer->node.next;
+	else
+		*head = timer->node.next;
+
+	if (timer->node.next != NULL)
+		timer->node.next->node.prev = timer->node.prev;
+
+	timer->node.next = NULL;
+	timer->node.prev = NULL;
+}
+
+/**
+ * @brief Moves timer of doubly linked list after its expiry time was changed.
+ *
+ * @param head The pointer to the list head.
+ *
+ * @param timer The pointer to timer in the list.
+ */
+static inline void sw_timer_engine_list_move(sw_timer_t **head, sw_timer_t *timer)
+{
+	uint32_t key = SW_TIMER_ENGINE_KEY(timer->time);
+	sw_timer_t *prev = timer->node.prev;
+	sw_timer_t *next = timer->node.next;
+
+	/* Search goes from the current position to the direction of the move,
+	 * timers with equal time keep start order */
+	if ((prev != NULL) && (SW_TIMER_ENGINE_KEY(prev->time) > key)) {
+		do {
+			next = prev;
+			prev = prev->node.prev;
+		} while ((prev != NULL) && (SW_TIMER_ENGINE_KEY(prev->time) > key));
+	} else if ((next != NULL) && (SW_TIMER_ENGINE_KEY(next->time) <= key)) {
+		do {
+			prev = next;
+			next = next->node.next;
+		} while ((next != NULL) && (SW_TIMER_ENGINE_KEY(next->time) <= key));
+	} else {
+		return;
+	}
+
+	sw_timer_engine_list_remove(head, timer);
+
+	timer->node.prev = prev;
+	timer->node.next = next;
+
+	if (prev != NULL)
+		prev->node.next = timer;
+	else
+		*head = timer;
+
+	if (next != NULL)
+		next->node.prev = timer;
+}
+
+#endif
+
+#endif /* SW_TIMER_ENGINE_H */
@@ -0,0 +1,163 @@
+#include "sw_timer_engine.h"
+#include "sw_timer_heap.h"
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE
+
+/**
+ * @brief The head of doubly linked list sorted by expiry time, used while
+ * the engine is in the list mode.
+ */
+static sw_timer_t *head = NULL;
+
+/**
+ * @brief Heap used while the engine is in the heap mode.
+ */
+static sw_timer_heap_t heap = { NULL, 0 };
+
+/**
+ * @brief Non-zero value while the engine is in the heap mode.
+ */
+static uint32_t heap_mode = 0;
+
+/**
+ * @brief Number of running timers.
+ */
+static uint32_t count = 0;
+
+/**
+ * @brief Number of switches between list and heap modes.
+ */
+static uint32_t migrations = 0;
+
+/**
+ * @brief Moves all timers from the sorted list to the heap in one pass.
+ *
+ * Sorted list is already a valid heap, the list order is the heap level order.
+ */
+static void sw_timer_adaptive_to_heap(void);
+
+/**
+ * @brief Moves all timers from the heap to the list.
+ */
+static void sw_timer_adaptive_to_list(void);
+
+void sw_timer_engine_insert(sw_timer_t *timer)
+{
+	count++;
+
+	if (heap_mode) {
+		sw_timer_heap_insert(&heap, timer);
+	} else if (sw_timer_engine_list_insert(&head, timer) > SW_TIMER_ADAPTIVE_HEAP_STEPS) {
+		sw_timer_adaptive_to_heap();
+	}
+}
+
+void sw_timer_engine_remove(sw_timer_t *timer)
+{
+	count--;
+
+	if (heap_mode) {
+		sw_timer_heap_remove(&heap, timer);
+
+		if (count < SW_TIMER_ADAPTIVE_LIST_COUNT)
+			sw_timer_adaptive_to_list();
+	} else {
+		sw_timer_engine_list_remove(&head, timer);
+	}
+}
+
+void sw_timer_engine_move(sw_timer_t *timer)
+{
+	if (heap_mode)
+		sw_timer_heap_update(&heap, timer);
+	else
+		sw_timer_engine_list_move(&head, timer);
+}
+
+sw_timer_t *sw_timer_engine_peek(void)
+{
+	return heap_mode ? sw_timer_heap_peek(&heap) : head;
+}
+
+void sw_timer_engine_shift(uint32_t shift_time)
+{
+	/* Keys are calculated from the epoch on every comparison */
+	(void) shift_time;
+}
+
+void sw_timer_engine_get_stats(sw_timer_stats_t *stats)
+{
+	stats->migrations = migrations;
+}
+
+static void sw_timer_adaptive_to_heap(void)
+{
+	sw_timer_t *parent = head;
+	sw_timer_t *timer = head;
+	uint32_t index = 0;
+
+	heap.min = NULL;
+	heap.count = 0;
+
+	/* Node with index i is child of node with index (i - 1) / 2, so parents
+	 * follow the list order too, two children each */
+	while (timer) {
+		sw_timer_heap_node_t *heap_node = &timer->node.heap;
+
+		heap_node->left = NULL;
+		heap_node->right = NULL;
+
+		if (index == 0) {
+			heap_node->parent = NULL;
+			heap.min = heap_node;
+		} else {
+			heap_node->parent = &parent->node.heap;
+
+			if (index & 1) {
+				parent->node.heap.left = heap_node;
+			} else {
+				parent->node.heap.right = heap_node;
+				parent = parent->node.next;
+			}
+		}
+
+		index++;
+		timer = timer->node.next;
+	}
+
+	heap.count = index;
+
+	head = NULL;
+	heap_mode = 1;
+
+	migrations++;
+}
+
+static void sw_timer_adaptive_to_list(void)
+{
+	sw_timer_t *tail = NULL;
+	sw_timer_t *timer;
+
+	head = NULL;
+
+	/* Called only for a few timers, so sorting by the heap is cheap */
+	while ((timer = sw_timer_heap_peek(&heap)) != NULL) {
+		sw_timer_heap_remove(&heap, timer);
+
+		timer->node.prev = tail;
+		timer->node.next = NULL;
+
+		if (tail != NULL)
+			tail->node.next = timer;
+		else
+			head = timer;
+
+		tail = timer;
+	}
+
+	heap_mode = 0;
+
+	migrations++;
+}
+
+#endif /* SW_TIMER_ENGINE == SW_TIMER_ENGINE_ADAPTIVE */
@@ -0,0 +1,205 @@
+#include "sw_timer_engine.h"
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_FIFO
+
+/**
+ * @brief Per-period FIFO type.
+ *
+ * Timers with the same period started in order expire in order, so a new
+ * timer is appended at the FIFO tail. The FIFO is assigned to a period while
+ * it is not empty.
+ */
+typedef struct SW_TIMER_FIFO
+{
+	// A period of all timers in the FIFO
+	uint32_t period;
+
+	// An index of the FIFO in the heap
+	uint32_t index;
+
+	// A pointer to the first node
+	sw_timer_t *head;
+
+	// A pointer to the last node
+	sw_timer_t *tail;
+} sw_timer_fifo_t;
+
+/**
+ * @brief Per-period FIFOs, the last one holds timers of any period when all
+ * other FIFOs are assigned.
+ */
+static sw_timer_fifo_t fifos[SW_TIMER_FIFO_PERIODS + 1];
+
+/**
+ * @brief Binary min-heap of not empty FIFOs ordered by expiry time of heads.
+ */
+static sw_timer_fifo_t *heap[SW_TIMER_FIFO_PERIODS + 1];
+
+/**
+ * @brief Number of FIFOs in the heap.
+ */
+static uint32_t heap_size = 0;
+
+/**
+ * @brief Finds FIFO for the period.
+ *
+ * @param period The timer period.
+ *
+ * @return The pointer to FIFO assigned to the period, or free FIFO, or
+ * overflow FIFO if all FIFOs are assigned to other periods.
+ */
+static sw_timer_fifo_t *sw_timer_fifo_find(uint32_t period);
+
+/**
+ * @brief Moves FIFO to the heap root direction while it is less than parent.
+ *
+ * @param fifo The pointer to FIFO in the heap.
+ */
+static void sw_timer_fifo_sift_up(sw_timer_fifo_t *fifo);
+
+/**
+ * @brief Moves FIFO to the heap leaves direction while it is greater than child.
+ *
+ * @param fifo The pointer to FIFO in the heap.
+ */
+static void sw_timer_fifo_sift_down(sw_timer_fifo_t *fifo);
+
+void sw_timer_engine_insert(sw_timer_t *timer)
+{
+	sw_timer_fifo_t *fifo = sw_timer_fifo_find(timer->period);
+	sw_timer_t *prev = fifo->tail;
+
+	/* Usually the loop exits immediately, timers of overflow FIFO and timers
+	 * restarted from the interrupt handler with a delay need search */
+	while (prev && (SW_TIMER_ENGINE_KEY(prev->time) > SW_TIMER_ENGINE_KEY(timer->time)))
+		prev = prev->node.prev;
+
+	timer->node.fifo = fifo;
+	timer->node.prev = prev;
+
+	if (prev != NULL) {
+		timer->node.next = prev->node.next;
+		prev->node.next = timer;
+	} else {
+		timer->node.next = fifo->head;
+		fifo->head = timer;
+	}
+
+	if (timer->node.next != NULL)
+		timer->node.next->node.prev = timer;
+	else
+		fifo->tail = timer;
+
+	if (fifo->head == timer) {
+		if (timer->node.next == NULL) {
+			fifo->period = timer->period;
+			fifo->index = heap_size;
+			heap[heap_size++] = fifo;
+		}
+
+		sw_timer_fifo_sift_up(fifo);
+	}
+}
+
+void sw_timer_engine_remove(sw_timer_t *timer)
+{
+	sw_timer_fifo_t *fifo = timer->node.fifo;
+	sw_timer_t *prev = timer->node.prev;
+
+	if (prev != NULL)
+		timer->node.prev->node.next = timer->node.next;
+	else
+		fifo->head = timer->node.next;
+
+	if (timer->node.next != NULL)
+		timer->node.next->node.prev = timer->node.prev;
+	else
+		fifo->tail = timer->node.prev;
+
+	timer->node.next = NULL;
+	timer->node.prev = NULL;
+	timer->node.fifo = NULL;
+
+	if (fifo->head == NULL) {
+		sw_timer_fifo_t *last = heap[--heap_size];
+
+		if (last != fifo) {
+			last->index = fifo->index;
+			heap[last->index] = last;
+
+			sw_timer_fifo_sift_up(last);
+			sw_timer_fifo_sift_down(last);
+		}
+	} else if (prev == NULL) {
+		sw_timer_fifo_sift_down(fifo);
+	}
+}
+
+sw_timer_t *sw_timer_engine_peek(void)
+{
+	return (heap_size != 0) ? heap[0]->head : NULL;
+}
+
+void sw_timer_engine_shift(uint32_t shift_time)
+{
+	/* Keys are calculated from the epoch on every comparison */
+	(void) shift_time;
+}
+
+static sw_timer_fifo_t *sw_timer_fifo_find(uint32_t period)
+{
+	sw_timer_fifo_t *free_fifo = &fifos[SW_TIMER_FIFO_PERIODS];
+	uint32_t i;
+
+	for (i = 0; i < SW_TIMER_FIFO_PERIODS; i++) {
+		if (fifos[i].head == NULL) {
+			if (free_fifo == &fifos[SW_TIMER_FIFO_PERIODS])
+				free_fifo = &fifos[i];
+		} else if (fifos[i].period == period) {
+			return &fifos[i];
+		}
+	}
+
+	return free_fifo;
+}
+
+static void sw_timer_fifo_sift_up(sw_timer_fifo_t *fifo)
+{
+	while (fifo->index != 0) {
+		sw_timer_fifo_t *parent = heap[(fifo->index - 1) / 2];
+
+		if (SW_TIMER_ENGINE_KEY(parent->head->time) <= SW_TIMER_ENGINE_KEY(fifo->head->time))
+			break;
+
+		heap[fifo->index] = parent;
+		heap[parent->index] = fifo;
+
+		parent->index = fifo->index;
+		fifo->index = (fifo->index - 1) / 2;
+	}
+}
+
+static void sw_timer_fifo_sift_down(sw_timer_fifo_t *fifo)
+{
+	for (;;) {
+		uint32_t child = fifo->index * 2 + 1;
+
+		if (child >= heap_size)
+			break;
+
+		if ((child + 1 < heap_size)
+				&& (SW_TIMER_ENGINE_KEY(heap[child + 1]->head->time) < SW_TIMER_ENGINE_KEY(heap[child]->head->time)))
+			child++;
+
+		if (SW_TIMER_ENGINE_KEY(fifo->head->time) <= SW_TIMER_ENGINE_KEY(heap[child]->head->time))
+			break;
+
+		heap[fifo->index] = heap[child];
+		heap[child] = fifo;
+
+		heap[fifo->index]->index = fifo->index;
+		fifo->index = child;
+	}
+}
+
+#endif /* SW_TIMER_ENGINE == SW_TIMER_ENGINE_FIFO */
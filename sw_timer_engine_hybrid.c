@@ -0,0 +1,417 @@
+#include "sw_timer_engine.h"
+#include "sw_timer_heap.h"
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID
+
+/**
+ * @brief Time covered by the wheel, one slot less than whole wheel, so the
+ * first and the last slots never hold timers of different wheel turns.
+ */
+#define SW_TIMER_WHEEL_SPAN ((SW_TIMER_WHEEL_SLOTS - 1) * SW_TIMER_WHEEL_RESOLUTION)
+
+/**
+ * @brief Cancellation counter value from which timers go to the wheel.
+ */
+#define SW_TIMER_HYBRID_WHEEL_THRESHOLD 2
+
+/**
+ * @brief Maximum cancellation counter value.
+ */
+#define SW_TIMER_HYBRID_COUNTER_MAX 3
+
+/**
+ * @brief Cancellation history type.
+ *
+ * Saturating counter is incremented when a timer of the period is stopped
+ * and decremented when it expires.
+ */
+typedef struct SW_TIMER_HYBRID_HISTORY
+{
+	// A timer period
+	uint32_t period;
+
+	// A saturating cancellation counter
+	uint32_t counter;
+} sw_timer_hybrid_history_t;
+
+/**
+ * @brief Cancellation history of recently used periods.
+ */
+static sw_timer_hybrid_history_t history[SW_TIMER_HYBRID_PERIODS];
+
+/**
+ * @brief The next history entry to be replaced by a new period.
+ */
+static uint32_t history_victim = 0;
+
+/**
+ * @brief Heap of timers that usually expire.
+ */
+static sw_timer_heap_t heap = { NULL, 0 };
+
+/**
+ * @brief Timing wheel slots, each slot is unsorted doubly linked list.
+ */
+static sw_timer_t *slots[SW_TIMER_WHEEL_SLOTS];
+
+/**
+ * @brief Number of timers in the wheel.
+ */
+static uint32_t wheel_count = 0;
+
+/**
+ * @brief Key not greater than key of any wheel timer.
+ */
+static uint32_t wheel_floor = 0;
+
+/**
+ * @brief Key not less than key of any wheel timer.
+ */
+static uint32_t wheel_ceiling = 0;
+
+/**
+ * @brief Non-zero value if timers were unlinked from the wheel since the
+ * floor and the ceiling were last found by a scan.
+ */
+static uint32_t wheel_bounds_stale = 0;
+
+/**
+ * @brief The earliest wheel timer or NULL if it need be searched.
+ */
+static sw_timer_t *wheel_min = NULL;
+
+/**
+ * @brief Number of timers started in the wheel.
+ */
+static uint32_t wheel_started = 0;
+
+/**
+ * @brief Number of timers started in the heap.
+ */
+static uint32_t heap_started = 0;
+
+/**
+ * @brief Finds cancellation history of the period, replaces the oldest entry
+ * if the period has no history.
+ *
+ * @param period The timer period.
+ *
+ * @return The pointer to history entry.
+ */
+static sw_timer_hybrid_history_t *sw_timer_hybrid_history(uint32_t period);
+
+/**
+ * @brief Inserts timer to the wheel if its period is usually stopped and it
+ * fits the wheel, otherwise to the heap.
+ *
+ * @param timer The pointer to timer.
+ *
+ * @return Non-zero value if the timer is inserted to the wheel.
+ */
+static uint32_t sw_timer_hybrid_link(sw_timer_t *timer);
+
+/**
+ * @brief Returns non-zero value if the key fits the wheel, widens the floor
+ * or the ceiling to it.
+ *
+ * @param key The timer key.
+ *
+ * @return Non-zero value if the key fits the wheel.
+ */
+static uint32_t sw_timer_wheel_fit(uint32_t key);
+
+/**
+ * @brief Finds the floor and the ceiling of the wheel by a scan, so they
+ * shrink after the earliest or the latest wheel timers are gone.
+ */
+static void sw_timer_wheel_bounds(void);
+
+/**
+ * @brief Unlinks timer from the wheel or the heap.
+ *
+ * @param timer The pointer to timer.
+ */
+static void sw_timer_hybrid_unlink(sw_timer_t *timer);
+
+/**
+ * @brief Links timer to the wheel slot selected by the timer key.
+ *
+ * @param timer The pointer to timer.
+ */
+static void sw_timer_wheel_link(sw_timer_t *timer);
+
+/**
+ * @brief Searches the earliest wheel timer.
+ *
+ * @return The pointer to timer or NULL if the wheel is empty.
+ */
+static sw_timer_t *sw_timer_wheel_min(void);
+
+void sw_timer_engine_insert(sw_timer_t *timer)
+{
+	if (sw_timer_hybrid_link(timer))
+		wheel_started++;
+	else
+		heap_started++;
+}
+
+void sw_timer_engine_remove(sw_timer_t *timer)
+{
+	sw_timer_hybrid_history_t *entry = sw_timer_hybrid_history(timer->period);
+
+	if (entry->counter < SW_TIMER_HYBRID_COUNTER_MAX)
+		entry->counter++;
+
+	sw_timer_hybrid_unlink(timer);
+}
+
+void sw_timer_engine_expire(sw_timer_t *timer)
+{
+	sw_timer_hybrid_history_t *entry = sw_timer_hybrid_history(timer->period);
+
+	if (entry->counter > 0)
+		entry->counter--;
+
+	sw_timer_hybrid_unlink(timer);
+}
+
+void sw_timer_engine_move(sw_timer_t *timer)
+{
+	/* Heap timers are moved inside the heap, wheel timers are moved to the
+	 * slot of the new time or to the heap if the time does not fit the wheel */
+	if (timer->node.slot == NULL) {
+		sw_timer_heap_update(&heap, timer);
+	} else {
+		sw_timer_hybrid_unlink(timer);
+		sw_timer_hybrid_link(timer);
+	}
+}
+
+sw_timer_t *sw_timer_engine_peek(void)
+{
+	sw_timer_t *heap_timer = sw_timer_heap_peek(&heap);
+	sw_timer_t *wheel_timer = sw_timer_wheel_min();
+
+	if (heap_timer == NULL)
+		return wheel_timer;
+
+	if ((wheel_timer != NULL) && (SW_TIMER_ENGINE_KEY(wheel_timer->time) < SW_TIMER_ENGINE_KEY(heap_timer->time)))
+		return wheel_timer;
+
+	return heap_timer;
+}
+
+void sw_timer_engine_shift(uint32_t shift_time)
+{
+	sw_timer_t *timers = NULL;
+	uint32_t i;
+
+	/* Wheel slots depend on keys, so all timers are linked again */
+	for (i = 0; i < SW_TIMER_WHEEL_SLOTS; i++) {
+		while (slots[i] != NULL) {
+			sw_timer_t *timer = slots[i];
+
+			slots[i] = timer->node.link.wheel.next;
+
+			timer->node.link.wheel.next = timers;
+			timers = timer;
+		}
+	}
+
+	wheel_floor = (wheel_floor > shift_time) ? (wheel_floor - shift_time) : 0;
+	wheel_ceiling -= shift_time;
+
+	while (timers) {
+		sw_timer_t *next = timers->node.link.wheel.next;
+
+		sw_timer_wheel_link(timers);
+
+		timers = next;
+	}
+}
+
+void sw_timer_engine_get_stats(sw_timer_stats_t *stats)
+{
+	stats->wheel_started = wheel_started;
+	stats->heap_started = heap_started;
+}
+
+static sw_timer_hybrid_history_t *sw_timer_hybrid_history(uint32_t period)
+{
+	sw_timer_hybrid_history_t *entry;
+	uint32_t i;
+
+	for (i = 0; i < SW_TIMER_HYBRID_PERIODS; i++) {
+		if (history[i].period == period)
+			return &history[i];
+	}
+
+	/* New periods are expected to expire */
+	entry = &history[history_victim];
+	entry->period = period;
+	entry->counter = SW_TIMER_HYBRID_WHEEL_THRESHOLD - 1;
+
+	history_victim = (history_victim + 1) % SW_TIMER_HYBRID_PERIODS;
+
+	return entry;
+}
+
+static uint32_t sw_timer_hybrid_link(sw_timer_t *timer)
+{
+	sw_timer_hybrid_history_t *entry = sw_timer_hybrid_history(timer->period);
+	uint32_t key = SW_TIMER_ENGINE_KEY(timer->time);
+
+	if (entry->counter >= SW_TIMER_HYBRID_WHEEL_THRESHOLD) {
+		uint32_t fits = sw_timer_wheel_fit(key);
+
+		/* Bounds left by unlinked timers are found again before the timer
+		 * is given to the heap */
+		if (!fits && wheel_bounds_stale) {
+			sw_timer_wheel_bounds();
+
+			fits = sw_timer_wheel_fit(key);
+		}
+
+		if (fits) {
+			if (((wheel_min != NULL) && (key < SW_TIMER_ENGINE_KEY(wheel_min->time))) || (wheel_count == 0))
+				wheel_min = timer;
+
+			wheel_count++;
+
+			sw_timer_wheel_link(timer);
+
+			return 1;
+		}
+	}
+
+	timer->node.slot = NULL;
+
+	sw_timer_heap_insert(&heap, timer);
+
+	return 0;
+}
+
+static uint32_t sw_timer_wheel_fit(uint32_t key)
+{
+	if (wheel_count == 0) {
+		wheel_floor = key;
+		wheel_ceiling = key;
+		wheel_bounds_stale = 0;
+	} else if (key >= wheel_floor) {
+		if (key - wheel_floor >= SW_TIMER_WHEEL_SPAN)
+			return 0;
+
+		if (key > wheel_ceiling)
+			wheel_ceiling = key;
+	} else {
+		if (wheel_ceiling - key >= SW_TIMER_WHEEL_SPAN)
+			return 0;
+
+		wheel_floor = key;
+	}
+
+	return 1;
+}
+
+static void sw_timer_wheel_bounds(void)
+{
+	uint32_t i;
+
+	wheel_bounds_stale = 0;
+
+	if (wheel_count == 0)
+		return;
+
+	wheel_floor = 0xffffffff;
+	wheel_ceiling = 0;
+
+	for (i = 0; i < SW_TIMER_WHEEL_SLOTS; i++) {
+		sw_timer_t *timer = slots[i];
+
+		while (timer) {
+			uint32_t key = SW_TIMER_ENGINE_KEY(timer->time);
+
+			if (key < wheel_floor)
+				wheel_floor = key;
+
+			if (key > wheel_ceiling)
+				wheel_ceiling = key;
+
+			timer = timer->node.link.wheel.next;
+		}
+	}
+}
+
+static void sw_timer_hybrid_unlink(sw_timer_t *timer)
+{
+	if (timer->node.slot != NULL) {
+		if (timer->node.link.wheel.prev != NULL)
+			timer->node.link.wheel.prev->node.link.wheel.next = timer->node.link.wheel.next;
+		else
+			*timer->node.slot = timer->node.link.wheel.next;
+
+		if (timer->node.link.wheel.next != NULL)
+			timer->node.link.wheel.next->node.link.wheel.prev = timer->node.link.wheel.prev;
+
+		timer->node.link.wheel.next = NULL;
+		timer->node.link.wheel.prev = NULL;
+		timer->node.slot = NULL;
+
+		wheel_count--;
+		wheel_bounds_stale = 1;
+
+		if (wheel_min == timer)
+			wheel_min = NULL;
+	} else {
+		sw_timer_heap_remove(&heap, timer);
+	}
+}
+
+static void sw_timer_wheel_link(sw_timer_t *timer)
+{
+	sw_timer_t **slot = &slots[(SW_TIMER_ENGINE_KEY(timer->time) / SW_TIMER_WHEEL_RESOLUTION) % SW_TIMER_WHEEL_SLOTS];
+
+	timer->node.slot = slot;
+	timer->node.link.wheel.prev = NULL;
+	timer->node.link.wheel.next = *slot;
+
+	if (*slot != NULL)
+		(*slot)->node.link.wheel.prev = timer;
+
+	*slot = timer;
+}
+
+static sw_timer_t *sw_timer_wheel_min(void)
+{
+	uint32_t index;
+	uint32_t i;
+
+	if ((wheel_min != NULL) || (wheel_count == 0))
+		return wheel_min;
+
+	/* All wheel timers are within one wheel turn from the floor */
+	index = (wheel_floor / SW_TIMER_WHEEL_RESOLUTION) % SW_TIMER_WHEEL_SLOTS;
+
+	for (i = 0; i < SW_TIMER_WHEEL_SLOTS; i++) {
+		sw_timer_t *timer = slots[index];
+
+		while (timer) {
+			if ((wheel_min == NULL) || (SW_TIMER_ENGINE_KEY(timer->time) < SW_TIMER_ENGINE_KEY(wheel_min->time)))
+				wheel_min = timer;
+
+			timer = timer->node.link.wheel.next;
+		}
+
+		if (wheel_min != NULL) {
+			wheel_floor = SW_TIMER_ENGINE_KEY(wheel_min->time);
+
+			break;
+		}
+
+		index = (index + 1) % SW_TIMER_WHEEL_SLOTS;
+	}
+
+	return wheel_min;
+}
+
+#endif /* SW_TIMER_ENGINE == SW_TIMER_ENGINE_HYBRID */
@@ -0,0 +1,36 @@
+#include "sw_timer_engine.h"
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_LIST
+
+/**
+ * @brief The head of doubly linked list sorted by expiry time.
+ */
+static sw_timer_t *head = NULL;
+
+void sw_timer_engine_insert(sw_timer_t *timer)
+{
+	sw_timer_engine_list_insert(&head, timer);
+}
+
+void sw_timer_engine_remove(sw_timer_t *timer)
+{
+	sw_timer_engine_list_remove(&head, timer);
+}
+
+void sw_timer_engine_move(sw_timer_t *timer)
+{
+	sw_timer_engine_list_move(&head, timer);
+}
+
+sw_timer_t *sw_timer_engine_peek(void)
+{
+	return head;
+}
+
+void sw_timer_engine_shift(uint32_t shift_time)
+{
+	/* Keys are calculated from the epoch on every comparison */
+	(void) shift_time;
+}
+
+#endif /* SW_TIMER_ENGINE == SW_TIMER_ENGINE_LIST */
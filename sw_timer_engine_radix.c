@@ -0,0 +1,189 @@
+#include "sw_timer_engine.h"
+
+#if SW_TIMER_ENGINE == SW_TIMER_ENGINE_RADIX
+
+/**
+ * @brief Number of radix heap buckets.
+ *
+ * Bucket 0 holds timers with key equal to the last minimum, bucket i holds
+ * timers whose key differs from the last minimum at most significant bit i - 1.
+ */
+#define SW_TIMER_RADIX_BUCKETS 33
+
+/**
+ * @brief Radix heap buckets, each bucket is doubly linked list.
+ */
+static sw_timer_t *buckets[SW_TIMER_RADIX_BUCKETS];
+
+/**
+ * @brief The last minimum key, all running timers have key greater or equal
+ * to it.
+ */
+static uint32_t last = 0;
+
+/**
+ * @brief Returns number of significant bits.
+ *
+ * @param value The value.
+ *
+ * @return The position of most significant set bit plus one, or 0 for 0.
+ */
+static uint32_t sw_timer_radix_bit_length(uint32_t value);
+
+/**
+ * @brief Links timer to the bucket selected by the timer key.
+ *
+ * @param timer The pointer to timer.
+ */
+static void sw_timer_radix_link(sw_timer_t *timer);
+
+void sw_timer_engine_insert(sw_timer_t *timer)
+{
+	uint32_t key = SW_TIMER_ENGINE_KEY(timer->time);
+
+	/* A new timer could be started earlier than the last minimum. All timers
+	 * in buckets below the highest differing bit of new minimum belong to
+	 * that bucket, the bucket itself is empty. */
+	if (key < last) {
+		uint32_t top = sw_timer_radix_bit_length(key ^ last);
+		uint32_t i;
+
+		for (i = 0; i < top; i++) {
+			while (buckets[i] != NULL) {
+				sw_timer_t *moved = buckets[i];
+
+				buckets[i] = moved->node.next;
+
+				moved->node.next = buckets[top];
+				moved->node.prev = NULL;
+				moved->node.bucket = &buckets[top];
+
+				if (buckets[top] != NULL)
+					buckets[top]->node.prev = moved;
+
+				buckets[top] = moved;
+			}
+		}
+
+		last = key;
+	}
+
+	sw_timer_radix_link(timer);
+}
+
+void sw_timer_engine_remove(sw_timer_t *timer)
+{
+	if (timer->node.prev != NULL)
+		timer->node.prev->node.next = timer->node.next;
+	else
+		*timer->node.bucket = timer->node.next;
+
+	if (timer->node.next != NULL)
+		timer->node.next->node.prev = timer->node.prev;
+
+	timer->node.next = NULL;
+	timer->node.prev = NULL;
+	timer->node.bucket = NULL;
+}
+
+sw_timer_t *sw_timer_engine_peek(void)
+{
+	uint32_t i;
+
+	if (buckets[0] != NULL)
+		return buckets[0];
+
+	for (i = 1; i < SW_TIMER_RADIX_BUCKETS; i++) {
+		if (buckets[i] != NULL) {
+			sw_timer_t *timer = buckets[i];
+			sw_timer_t *min = timer;
+
+			while (timer) {
+				if (SW_TIMER_ENGINE_KEY(timer->time) < SW_TIMER_ENGINE_KEY(min->time))
+					min = timer;
+
+				timer = timer->node.next;
+			}
+
+			last = SW_TIMER_ENGINE_KEY(min->time);
+
+			/* Every timer of the bucket goes to a lower bucket */
+			timer = buckets[i];
+			buckets[i] = NULL;
+
+			while (timer) {
+				sw_timer_t *next = timer->node.next;
+
+				sw_timer_radix_link(timer);
+
+				timer = next;
+			}
+
+			return buckets[0];
+		}
+	}
+
+	return NULL;
+}
+
+void sw_timer_engine_shift(uint32_t shift_time)
+{
+	sw_timer_t *timers = NULL;
+	uint32_t i;
+
+	/* Buckets depend on bits of keys, so all timers are linked again */
+	for (i = 0; i < SW_TIMER_RADIX_BUCKETS; i++) {
+		while (buckets[i] != NULL) {
+			sw_timer_t *timer = buckets[i];
+
+			buckets[i] = timer->node.next;
+
+			timer->node.next = timers;
+			timers = timer;
+		}
+	}
+
+	/* All keys are not less than 0 from the new epoch */
+	last = 0;
+	(void) shift_time;
+
+	while (timers) {
+		sw_timer_t *next = timers->node.next;
+
+		sw_timer_engine_insert(timers);
+
+		timers = next;
+	}
+}
+
+static uint32_t sw_timer_radix_bit_length(uint32_t value)
+{
+#if defined(__GNUC__)
+	return (value != 0) ? (32 - (uint32_t) __builtin_clz(value)) : 0;
+#else
+	uint32_t length = 0;
+
+	while (value) {
+		length++;
+		value >>= 1;
+	}
+
+	return length;
+#endif
+}
+
+static void sw_timer_radix_link(sw_timer_t *timer)
+{
+	sw_timer_t **bucket = &buckets[sw_timer_radix_bit_length(SW_TIMER_ENGINE_KEY(timer->time) ^ last)];
+
+	timer->node.bucket = bucket;
+	timer->node.prev = NULL;
+	timer->node.next = *bucket;
+
+	if (*bucket != NULL)
+		(*bucket)->node.prev = timer;
+
+	*bucket = timer;
+}
+
+#endif /* SW_TIMER_ENGINE == SW_TIMER_ENGINE_RADIX */
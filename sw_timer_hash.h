@@ -0,0 +1,34 @@
+#ifndef SW_TIMER_HASH_H
+#define SW_TIMER_HASH_H
+
+#include <stdint.h>
+
+/**
+ * @brief 64-bit key hashing shared by the key index and the TTL map.
+ *
+ * This header is not part of the public API and must not be included by
+ * application code.
+ */
+
+/**
+ * @brief Returns hash of the key.
+ *
+ * 64-bit finalizer of MurmurHash3, spreads keys packed from different bit
+ * fields over all low bits, so masking the hash selects a uniform slot.
+ *
+ * @param key The key.
+ *
+ * @return The hash.
+ */
+static inline uint32_t sw_timer_hash(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdull;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ull;
+	key ^= key >> 33;
+
+	return (uint32_t) key;
+}
+
+#endif /* SW_TIMER_HASH_H */
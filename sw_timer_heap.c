@@ -0,0 +1,224 @@
+#include <stddef.h>
+
+#include "sw_timer_heap.h"
+
+#ifdef SW_TIMER_ENGINE_HEAP_NODE
+
+/**
+ * @brief Returns timer that contains the heap node.
+ */
+#define SW_TIMER_HEAP_TIMER(heap_node) \
+	((sw_timer_t *) ((char *) (heap_node) - offsetof(sw_timer_t, SW_TIMER_ENGINE_HEAP_NODE)))
+
+/**
+ * @brief Compares expiry time of timers that contain heap nodes.
+ *
+ * @return Non-zero value if the first node is less than the second one.
+ */
+static int sw_timer_heap_less(sw_timer_heap_node_t *a, sw_timer_heap_node_t *b);
+
+/**
+ * @brief Swaps parent node with its child node.
+ *
+ * @param heap The pointer to heap.
+ *
+ * @param parent The pointer to parent node.
+ *
+ * @param child The pointer to child node.
+ */
+static void sw_timer_heap_swap(sw_timer_heap_t *heap, sw_timer_heap_node_t *parent, sw_timer_heap_node_t *child);
+
+void sw_timer_heap_insert(sw_timer_heap_t *heap, sw_timer_t *timer)
+{
+	sw_timer_heap_node_t *new_node = &timer->SW_TIMER_ENGINE_HEAP_NODE;
+	sw_timer_heap_node_t **parent;
+	sw_timer_heap_node_t **child;
+	uint32_t path;
+	uint32_t depth;
+	uint32_t n;
+
+	new_node->left = NULL;
+	new_node->right = NULL;
+	new_node->parent = NULL;
+
+	/* Path from the root to the first free leaf, bits of the node number */
+	path = 0;
+	for (depth = 0, n = heap->count + 1; n >= 2; depth++, n /= 2)
+		path = (path << 1) | (n & 1);
+
+	parent = child = &heap->min;
+
+	while (depth > 0) {
+		parent = child;
+
+		if (path & 1)
+			child = &(*child)->right;
+		else
+			child = &(*child)->left;
+
+		path >>= 1;
+		depth--;
+	}
+
+	new_node->parent = *parent;
+	*child = new_node;
+	heap->count++;
+
+	while ((new_node->parent != NULL) && sw_timer_heap_less(new_node, new_node->parent))
+		sw_timer_heap_swap(heap, new_node->parent, new_node);
+}
+
+void sw_timer_heap_remove(sw_timer_heap_t *heap, sw_timer_t *timer)
+{
+	sw_timer_heap_node_t *heap_node = &timer->SW_TIMER_ENGINE_HEAP_NODE;
+	sw_timer_heap_node_t *smallest;
+	sw_timer_heap_node_t **last;
+	sw_timer_heap_node_t *child;
+	uint32_t path;
+	uint32_t depth;
+	uint32_t n;
+
+	if (heap->count == 0)
+		return;
+
+	/* Path from the root to the last leaf */
+	path = 0;
+	for (depth = 0, n = heap->count; n >= 2; depth++, n /= 2)
+		path = (path << 1) | (n & 1);
+
+	last = &heap->min;
+
+	while (depth > 0) {
+		if (path & 1)
+			last = &(*last)->right;
+		else
+			last = &(*last)->left;
+
+		path >>= 1;
+		depth--;
+	}
+
+	heap->count--;
+
+	child = *last;
+	*last = NULL;
+
+	if (child == heap_node) {
+		if (child == heap->min)
+			heap->min = NULL;
+
+		return;
+	}
+
+	/* The last leaf replaces the removed node */
+	child->left = heap_node->left;
+	child->right = heap_node->right;
+	child->parent = heap_node->parent;
+
+	if (child->left != NULL)
+		child->left->parent = child;
+
+	if (child->right != NULL)
+		child->right->parent = child;
+
+	if (heap_node->parent == NULL)
+		heap->min = child;
+	else if (heap_node->parent->left == heap_node)
+		heap_node->parent->left = child;
+	else
+		heap_node->parent->right = child;
+
+	for (;;) {
+		smallest = child;
+
+		if ((child->left != NULL) && sw_timer_heap_less(child->left, smallest))
+			smallest = child->left;
+
+		if ((child->right != NULL) && sw_timer_heap_less(child->right, smallest))
+			smallest = child->right;
+
+		if (smallest == child)
+			break;
+
+		sw_timer_heap_swap(heap, child, smallest);
+	}
+
+	while ((child->parent != NULL) && sw_timer_heap_less(child, child->parent))
+		sw_timer_heap_swap(heap, child->parent, child);
+
+	heap_node->left = NULL;
+	heap_node->right = NULL;
+	heap_node->parent = NULL;
+}
+
+void sw_timer_heap_update(sw_timer_heap_t *heap, sw_timer_t *timer)
+{
+	sw_timer_heap_node_t *heap_node = &timer->SW_TIMER_ENGINE_HEAP_NODE;
+	sw_timer_heap_node_t *smallest;
+
+	while ((heap_node->parent != NULL) && sw_timer_heap_less(heap_node, heap_node->parent))
+		sw_timer_heap_swap(heap, heap_node->parent, heap_node);
+
+	for (;;) {
+		smallest = heap_node;
+
+		if ((heap_node->left != NULL) && sw_timer_heap_less(heap_node->left, smallest))
+			smallest = heap_node->left;
+
+		if ((heap_node->right != NULL) && sw_timer_heap_less(heap_node->right, smallest))
+			smallest = heap_node->right;
+
+		if (smallest == heap_node)
+			break;
+
+		sw_timer_heap_swap(heap, heap_node, smallest);
+	}
+}
+
+sw_timer_t *sw_timer_heap_peek(sw_timer_heap_t *heap)
+{
+	return (heap->min != NULL) ? SW_TIMER_HEAP_TIMER(heap->min) : NULL;
+}
+
+static int sw_timer_heap_less(sw_timer_heap_node_t *a, sw_timer_heap_node_t *b)
+{
+	return SW_TIMER_ENGINE_KEY(SW_TIMER_HEAP_TIMER(a)->time) < SW_TIMER_ENGINE_KEY(SW_TIMER_HEAP_TIMER(b)->time);
+}
+
+static void sw_timer_heap_swap(sw_timer_heap_t *heap, sw_timer_heap_node_t *parent, sw_timer_heap_node_t *child)
+{
+	sw_timer_heap_node_t *sibling;
+	sw_timer_heap_node_t node;
+
+	node = *parent;
+	*parent = *child;
+	*child = node;
+
+	parent->parent = child;
+
+	if (child->left == child) {
+		child->left = parent;
+		sibling = child->right;
+	} else {
+		child->right = parent;
+		sibling = child->left;
+	}
+
+	if (sibling != NULL)
+		sibling->parent = child;
+
+	if (parent->left != NULL)
+		parent->left->parent = parent;
+
+	if (parent->right != NULL)
+		parent->right->parent = parent;
+
+	if (child->parent == NULL)
+		heap->min = child;
+	else if (child->parent->left == parent)
+		child->parent->left = child;
+	else
+		child->parent->right = child;
+}
+
+#endif /* SW_TIMER_ENGINE_HEAP_NODE */
@@ -0,0 +1,67 @@
+#ifndef SW_TIMER_HEAP_H
+#define SW_TIMER_HEAP_H
+
+#include "sw_timer_engine.h"
+
+/**
+ * @brief Intrusive binary min-heap of timers ordered by expiry time.
+ *
+ * The heap is built from pointers embedded in timer buffers, so it has no
+ * capacity limit and needs no memory allocation. Engines using the heap must
+ * name the heap node member of sw_timer_engine_node_t as heap.
+ *
+ * This header is not part of the public API and must not be included by
+ * application code.
+ */
+
+/**
+ * @brief Heap type.
+ */
+typedef struct SW_TIMER_HEAP
+{
+	// A pointer to the root node
+	sw_timer_heap_node_t *min;
+
+	// A number of nodes
+	uint32_t count;
+} sw_timer_heap_t;
+
+/**
+ * @brief Inserts timer to the heap.
+ *
+ * @param heap The pointer to heap.
+ *
+ * @param timer The pointer to timer with already calculated expiry time.
+ */
+void sw_timer_heap_insert(sw_timer_heap_t *heap, sw_timer_t *timer);
+
+/**
+ * @brief Removes timer from the heap, the expiry time of the removed timer
+ * is not used.
+ *
+ * @param heap The pointer to heap.
+ *
+ * @param timer The pointer to timer in the heap.
+ */
+void sw_timer_heap_remove(sw_timer_heap_t *heap, sw_timer_t *timer);
+
+/**
+ * @brief Restores heap order after the expiry time of timer was changed, the
+ * timer is moved up or down from its current node.
+ *
+ * @param heap The pointer to heap.
+ *
+ * @param timer The pointer to timer in the heap.
+ */
+void sw_timer_heap_update(sw_timer_heap_t *heap, sw_timer_t *timer);
+
+/**
+ * @brief Returns timer with the earliest expiry time.
+ *
+ * @param heap The pointer to heap.
+ *
+ * @return The pointer to timer or NULL if the heap is empty.
+ */
+sw_timer_t *sw_timer_heap_peek(sw_timer_heap_t *heap);
+
+#endif /* SW_TIMER_HEAP_H */
@@ -0,0 +1,153 @@
+#include "sw_timer.h"
+#include "sw_timer_hash.h"
+
+#if SW_TIMER_KEY_SLOTS > 0
+
+#if (SW_TIMER_KEY_SLOTS & (SW_TIMER_KEY_SLOTS - 1)) != 0
+#error "SW_TIMER_KEY_SLOTS must be power of two"
+#endif
+
+/**
+ * @brief Key index entry type.
+ */
+typedef struct SW_TIMER_KEY_ENTRY
+{
+	// A timer key
+	uint64_t key;
+
+	// A timer handle, NULL for empty entry
+	sw_timer_handle_t timer;
+} sw_timer_key_entry_t;
+
+/**
+ * @brief Open addressing index with linear probing.
+ */
+static sw_timer_key_entry_t entries[SW_TIMER_KEY_SLOTS];
+
+/**
+ * @brief Number of bound keys.
+ */
+static uint32_t count = 0;
+
+/**
+ * @brief Returns home entry index of the key.
+ *
+ * @param key The timer key.
+ *
+ * @return The entry index.
+ */
+static uint32_t sw_timer_key_hash(uint64_t key);
+
+/**
+ * @brief Finds entry of the key.
+ *
+ * @param key The timer key.
+ *
+ * @return The pointer to entry of the key or to the empty entry that ends
+ * the probe sequence.
+ */
+static sw_timer_key_entry_t *sw_timer_key_lookup(uint64_t key);
+
+sw_timer_status_t sw_timer_key_bind(uint64_t key, sw_timer_handle_t timer)
+{
+	sw_timer_key_entry_t *entry;
+
+	if (timer == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	entry = sw_timer_key_lookup(key);
+
+	if (entry->timer == NULL) {
+		/* One entry is always left empty, so probing always ends */
+		if (count >= SW_TIMER_KEY_SLOTS - 1)
+			return SW_TIMER_STATUS_ERROR_KEY_INDEX_FULL;
+
+		entry->key = key;
+
+		count++;
+	}
+
+	entry->timer = timer;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_status_t sw_timer_key_unbind(uint64_t key)
+{
+	sw_timer_key_entry_t *entry = sw_timer_key_lookup(key);
+	uint32_t hole;
+	uint32_t i;
+
+	if (entry->timer == NULL)
+		return SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST;
+
+	/* Backward shift deletion, entries after the hole that could be placed
+	 * to it are moved, so lookups need no deletion marks */
+	hole = (uint32_t) (entry - entries);
+	i = hole;
+
+	for (;;) {
+		uint32_t home;
+
+		i = (i + 1) & (SW_TIMER_KEY_SLOTS - 1);
+
+		if (entries[i].timer == NULL)
+			break;
+
+		home = sw_timer_key_hash(entries[i].key);
+
+		if (((i - home) & (SW_TIMER_KEY_SLOTS - 1)) >= ((i - hole) & (SW_TIMER_KEY_SLOTS - 1))) {
+			entries[hole] = entries[i];
+			hole = i;
+		}
+	}
+
+	entries[hole].timer = NULL;
+
+	count--;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_handle_t sw_timer_key_find(uint64_t key)
+{
+	return sw_timer_key_lookup(key)->timer;
+}
+
+sw_timer_status_t sw_timer_key_reschedule(uint64_t key, uint32_t delay)
+{
+	sw_timer_handle_t timer = sw_timer_key_lookup(key)->timer;
+
+	if (timer == NULL)
+		return SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST;
+
+	return sw_timer_reschedule(timer, delay);
+}
+
+sw_timer_status_t sw_timer_key_stop(uint64_t key)
+{
+	sw_timer_handle_t timer = sw_timer_key_lookup(key)->timer;
+
+	if (timer == NULL)
+		return SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST;
+
+	return sw_timer_stop(timer);
+}
+
+static uint32_t sw_timer_key_hash(uint64_t key)
+{
+	/* Session ids and kinds are packed to different bit fields */
+	return sw_timer_hash(key) & (SW_TIMER_KEY_SLOTS - 1);
+}
+
+static sw_timer_key_entry_t *sw_timer_key_lookup(uint64_t key)
+{
+	uint32_t i = sw_timer_key_hash(key);
+
+	while ((entries[i].timer != NULL) && (entries[i].key != key))
+		i = (i + 1) & (SW_TIMER_KEY_SLOTS - 1);
+
+	return &entries[i];
+}
+
+#endif /* SW_TIMER_KEY_SLOTS > 0 */
@@ -0,0 +1,486 @@
+#include <assert.h>
+
+#include "sw_timer.h"
+
+#if SW_TIMER_LEASE_SLOTS > 0
+
+/**
+ * @brief Lease state when the lease is not granted.
+ */
+#define SW_TIMER_LEASE_STATE_IDLE 0
+
+/**
+ * @brief Lease state when the renewal is not delivered yet.
+ */
+#define SW_TIMER_LEASE_STATE_RENEW 1
+
+/**
+ * @brief Lease state when the renewal is delivered and the lease waits for
+ * being granted again or for expiry.
+ */
+#define SW_TIMER_LEASE_STATE_EXPIRE 2
+
+/**
+ * @brief Lease type.
+ */
+typedef struct SW_TIMER_LEASE
+{
+	// A pointer to the lease argument
+	void *arg;
+
+	// A pointer to the next lease in the list
+	struct SW_TIMER_LEASE *next;
+
+	// A pointer to the previous lease in the list
+	struct SW_TIMER_LEASE *prev;
+
+	// A pointer to the list the lease is linked to
+	struct SW_TIMER_LEASE **list;
+
+	// An expiry time in the manager time
+	uint32_t expiry;
+
+	// A start time of the granularity interval the lease is delivered at
+	uint32_t cell;
+
+	// A lease state
+	uint32_t state;
+} sw_timer_lease_t;
+
+/**
+ * @brief Wheel slots, each slot is unsorted doubly linked list of leases
+ * delivered at one granularity interval of some wheel turn.
+ */
+static sw_timer_lease_t *slots[SW_TIMER_LEASE_SLOTS];
+
+/**
+ * @brief Leases taken from the wheel and not delivered yet.
+ */
+static sw_timer_lease_t *pending = NULL;
+
+/**
+ * @brief Number of granted leases.
+ */
+static uint32_t count = 0;
+
+/**
+ * @brief Manager time when the wakeup timer is not running.
+ */
+static uint32_t base = 0;
+
+/**
+ * @brief Manager time of the wakeup.
+ */
+static uint32_t wake_time = 0;
+
+/**
+ * @brief Granularity interval the wakeup is for.
+ */
+static uint32_t wake_cell = 0;
+
+/**
+ * @brief Non-zero value while leases are delivered.
+ */
+static uint32_t delivering = 0;
+
+/**
+ * @brief Timer buffer of the wakeup timer.
+ */
+static sw_timer_buffer_t wakeup_timer_buffer;
+
+/**
+ * @brief The wakeup timer.
+ */
+static sw_timer_handle_t wakeup_timer = NULL;
+
+/**
+ * @brief Renewal bulk callback.
+ */
+static sw_timer_lease_func_t renew_callback = NULL;
+
+/**
+ * @brief Expiry bulk callback.
+ */
+static sw_timer_lease_func_t expire_callback = NULL;
+
+/**
+ * @brief Leases collected for one bulk callback call.
+ */
+static sw_timer_lease_handle_t batch[SW_TIMER_LEASE_BATCH];
+
+/**
+ * @brief Number of collected leases.
+ */
+static uint32_t batch_count = 0;
+
+/**
+ * @brief State of collected leases.
+ */
+static uint32_t batch_state = SW_TIMER_LEASE_STATE_IDLE;
+
+/**
+ * @brief Number of wakeups.
+ */
+static uint32_t wakeups = 0;
+
+/**
+ * @brief Returns the manager time.
+ *
+ * @return The current time.
+ */
+static uint32_t sw_timer_lease_now(void);
+
+/**
+ * @brief Links lease to the list.
+ *
+ * @param lease The pointer to not linked lease.
+ *
+ * @param list The pointer to the list head.
+ */
+static void sw_timer_lease_link(sw_timer_lease_t *lease, sw_timer_lease_t **list);
+
+/**
+ * @brief Unlinks lease from its list if it is linked.
+ *
+ * @param lease The pointer to lease.
+ */
+static void sw_timer_lease_unlink(sw_timer_lease_t *lease);
+
+/**
+ * @brief Links lease to the wheel slot of its cell.
+ *
+ * @param lease The pointer to not linked lease.
+ */
+static void sw_timer_lease_schedule(sw_timer_lease_t *lease);
+
+/**
+ * @brief Starts the wakeup timer for the cell.
+ *
+ * @param cell The start time of granularity interval.
+ *
+ * @param now The current time.
+ */
+static void sw_timer_lease_wake_at(uint32_t cell, uint32_t now);
+
+/**
+ * @brief Starts the wakeup timer for the earliest cell or stops it if there
+ * are no leases.
+ *
+ * @param now The current time.
+ */
+static void sw_timer_lease_wake_next(uint32_t now);
+
+/**
+ * @brief Collects lease for the bulk callback of the state.
+ *
+ * @param lease The pointer to lease.
+ *
+ * @param state The state the lease is delivered for.
+ */
+static void sw_timer_lease_batch_add(sw_timer_lease_t *lease, uint32_t state);
+
+/**
+ * @brief Calls the bulk callback for collected leases.
+ */
+static void sw_timer_lease_batch_flush(void);
+
+/**
+ * @brief Wakeup timer callback, delivers leases of due cells.
+ *
+ * @param arg Not used.
+ */
+static void sw_timer_lease_wakeup(void *arg);
+
+void sw_timer_lease_register_callbacks(sw_timer_lease_func_t renew, sw_timer_lease_func_t expire)
+{
+	renew_callback = renew;
+	expire_callback = expire;
+}
+
+sw_timer_lease_handle_t sw_timer_lease_create(void *arg, sw_timer_lease_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_lease_t) == sizeof(sw_timer_lease_buffer_t));
+
+	sw_timer_lease_t *lease = (sw_timer_lease_t *) buffer;
+
+	lease->arg = arg;
+	lease->next = NULL;
+	lease->prev = NULL;
+	lease->list = NULL;
+	lease->expiry = 0;
+	lease->cell = 0;
+	lease->state = SW_TIMER_LEASE_STATE_IDLE;
+
+	return lease;
+}
+
+void *sw_timer_lease_arg(sw_timer_lease_handle_t handle)
+{
+	return ((sw_timer_lease_t *) handle)->arg;
+}
+
+sw_timer_status_t sw_timer_lease_grant(sw_timer_lease_handle_t handle, uint32_t duration, uint32_t renew_ahead)
+{
+	sw_timer_lease_t *lease = (sw_timer_lease_t *) handle;
+	uint32_t now;
+	uint32_t due;
+
+	if (lease == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (wakeup_timer == NULL)
+		wakeup_timer = sw_timer_create(0, SW_TIMER_MODE_SINGLE_SHOT,
+				(sw_timer_func_ptr_t) sw_timer_lease_wakeup, NULL, &wakeup_timer_buffer);
+
+	if (lease->state != SW_TIMER_LEASE_STATE_IDLE) {
+		sw_timer_lease_unlink(lease);
+
+		count--;
+	}
+
+	now = sw_timer_lease_now();
+
+	if (duration >= 0x80000000)
+		duration = 0x7fffffff;
+
+	lease->expiry = now + duration;
+	lease->state = SW_TIMER_LEASE_STATE_RENEW;
+
+	/* Renewal is delivered at the start of the interval the renewal time is
+	 * in, so it is never late, and all leases of the interval share one
+	 * wakeup */
+	due = (renew_ahead < duration) ? (lease->expiry - renew_ahead) : now;
+	lease->cell = due - (due % SW_TIMER_LEASE_GRANULARITY);
+
+	if ((int32_t) (lease->cell - (now - (now % SW_TIMER_LEASE_GRANULARITY))) < 0)
+		lease->cell = now - (now % SW_TIMER_LEASE_GRANULARITY);
+
+	sw_timer_lease_schedule(lease);
+
+	count++;
+
+	if (!delivering && ((count == 1) || ((int32_t) (lease->cell - wake_cell) < 0)))
+		sw_timer_lease_wake_at(lease->cell, now);
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_status_t sw_timer_lease_release(sw_timer_lease_handle_t handle)
+{
+	sw_timer_lease_t *lease = (sw_timer_lease_t *) handle;
+
+	if (lease == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (lease->state != SW_TIMER_LEASE_STATE_IDLE) {
+		sw_timer_lease_unlink(lease);
+
+		lease->state = SW_TIMER_LEASE_STATE_IDLE;
+
+		/* A wakeup for no leases is harmless, the timer is only stopped
+		 * when there are no leases at all */
+		if ((--count == 0) && !delivering) {
+			base = sw_timer_lease_now();
+
+			sw_timer_stop(wakeup_timer);
+		}
+	}
+
+	return SW_TIMER_STATUS_OK;
+}
+
+uint32_t sw_timer_lease_wakeups(void)
+{
+	return wakeups;
+}
+
+static uint32_t sw_timer_lease_now(void)
+{
+	/* A running wakeup can be already due in the tick mode */
+	if ((wakeup_timer == NULL) || !sw_timer_is_running(wakeup_timer))
+		return base;
+
+	return wake_time - sw_timer_remaining(wakeup_timer);
+}
+
+static void sw_timer_lease_link(sw_timer_lease_t *lease, sw_timer_lease_t **list)
+{
+	lease->list = list;
+	lease->prev = NULL;
+	lease->next = *list;
+
+	if (*list != NULL)
+		(*list)->prev = lease;
+
+	*list = lease;
+}
+
+static void sw_timer_lease_unlink(sw_timer_lease_t *lease)
+{
+	if (lease->list == NULL)
+		return;
+
+	if (lease->prev != NULL)
+		lease->prev->next = lease->next;
+	else
+		*lease->list = lease->next;
+
+	if (lease->next != NULL)
+		lease->next->prev = lease->prev;
+
+	lease->next = NULL;
+	lease->prev = NULL;
+	lease->list = NULL;
+}
+
+static void sw_timer_lease_schedule(sw_timer_lease_t *lease)
+{
+	sw_timer_lease_link(lease, &slots[(lease->cell / SW_TIMER_LEASE_GRANULARITY) % SW_TIMER_LEASE_SLOTS]);
+}
+
+static void sw_timer_lease_wake_at(uint32_t cell, uint32_t now)
+{
+	uint32_t delay = ((int32_t) (cell - now) > 0) ? (cell - now) : 1;
+
+	wake_cell = cell;
+	wake_time = now + delay;
+
+	sw_timer_reschedule(wakeup_timer, delay);
+}
+
+static void sw_timer_lease_wake_next(uint32_t now)
+{
+	uint32_t cell = now - (now % SW_TIMER_LEASE_GRANULARITY);
+	sw_timer_lease_t *min = NULL;
+	uint32_t i;
+
+	if (count == 0) {
+		base = now;
+
+		sw_timer_stop(wakeup_timer);
+
+		return;
+	}
+
+	/* The first slot with a lease of this wheel turn has the earliest one,
+	 * otherwise the earliest lease of all turns is taken */
+	for (i = 0; i < SW_TIMER_LEASE_SLOTS; i++, cell += SW_TIMER_LEASE_GRANULARITY) {
+		sw_timer_lease_t *lease = slots[(cell / SW_TIMER_LEASE_GRANULARITY) % SW_TIMER_LEASE_SLOTS];
+
+		while (lease != NULL) {
+			if (lease->cell == cell) {
+				sw_timer_lease_wake_at(cell, now);
+
+				return;
+			}
+
+			if ((min == NULL) || ((int32_t) (lease->cell - min->cell) < 0))
+				min = lease;
+
+			lease = lease->next;
+		}
+	}
+
+	if (min != NULL)
+		sw_timer_lease_wake_at(min->cell, now);
+}
+
+static void sw_timer_lease_batch_add(sw_timer_lease_t *lease, uint32_t state)
+{
+	if (batch_state != state)
+		sw_timer_lease_batch_flush();
+
+	batch_state = state;
+	batch[batch_count++] = lease;
+
+	if (batch_count == SW_TIMER_LEASE_BATCH)
+		sw_timer_lease_batch_flush();
+}
+
+static void sw_timer_lease_batch_flush(void)
+{
+	sw_timer_lease_func_t callback = (batch_state == SW_TIMER_LEASE_STATE_RENEW) ? renew_callback : expire_callback;
+	uint32_t batch_size = batch_count;
+
+	batch_count = 0;
+
+	if ((batch_size != 0) && (callback != NULL))
+		callback(batch, batch_size);
+}
+
+static void sw_timer_lease_wakeup(void *arg)
+{
+	uint32_t now = wake_time;
+	uint32_t cell = now - (now % SW_TIMER_LEASE_GRANULARITY);
+	uint32_t i;
+
+	(void) arg;
+
+	base = now;
+	delivering = 1;
+	wakeups++;
+
+	/* Due leases are taken from the wakeup cell and, if the wakeup was late,
+	 * from the current cell */
+	for (i = 0; i < 2; i++) {
+		uint32_t slot_cell = (i == 0) ? wake_cell : cell;
+		sw_timer_lease_t *lease = slots[(slot_cell / SW_TIMER_LEASE_GRANULARITY) % SW_TIMER_LEASE_SLOTS];
+
+		while (lease != NULL) {
+			sw_timer_lease_t *next = lease->next;
+
+			if ((int32_t) (lease->cell - cell) <= 0) {
+				sw_timer_lease_unlink(lease);
+				sw_timer_lease_link(lease, &pending);
+			}
+
+			lease = next;
+		}
+	}
+
+	/* Callbacks could grant or release any lease, the pending list is kept
+	 * consistent by them */
+	while (pending != NULL) {
+		sw_timer_lease_t *lease = pending;
+
+		/* Collected renewals are delivered before an expiry, a lease granted
+		 * again by the renewal callback leaves the pending list */
+		if ((lease->state == SW_TIMER_LEASE_STATE_EXPIRE) && (batch_state == SW_TIMER_LEASE_STATE_RENEW) && (batch_count != 0)) {
+			sw_timer_lease_batch_flush();
+
+			continue;
+		}
+
+		sw_timer_lease_unlink(lease);
+
+		if (lease->state == SW_TIMER_LEASE_STATE_RENEW) {
+			uint32_t expiry = lease->expiry + SW_TIMER_LEASE_GRANULARITY - 1;
+
+			/* Expiry is delivered at the start of the interval after the
+			 * expiry time, so it is never early */
+			lease->state = SW_TIMER_LEASE_STATE_EXPIRE;
+			lease->cell = expiry - (expiry % SW_TIMER_LEASE_GRANULARITY);
+
+			if ((int32_t) (lease->expiry - now) <= 0)
+				sw_timer_lease_link(lease, &pending);
+			else
+				sw_timer_lease_schedule(lease);
+
+			sw_timer_lease_batch_add(lease, SW_TIMER_LEASE_STATE_RENEW);
+		} else {
+			lease->state = SW_TIMER_LEASE_STATE_IDLE;
+
+			count--;
+
+			sw_timer_lease_batch_add(lease, SW_TIMER_LEASE_STATE_EXPIRE);
+		}
+	}
+
+	sw_timer_lease_batch_flush();
+
+	delivering = 0;
+
+	sw_timer_lease_wake_next(now);
+}
+
+#endif /* SW_TIMER_LEASE_SLOTS > 0 */
@@ -0,0 +1,135 @@
+#include "sw_timer.h"
+
+#if SW_TIMER_POOL_SIZE > 0
+
+/**
+ * @brief Number of bits of the slot index in the timer id.
+ */
+#define SW_TIMER_POOL_INDEX_BITS 16
+
+/**
+ * @brief Mask of the slot index in the timer id.
+ */
+#define SW_TIMER_POOL_INDEX_MASK ((1u << SW_TIMER_POOL_INDEX_BITS) - 1)
+
+#if SW_TIMER_POOL_SIZE > SW_TIMER_POOL_INDEX_MASK
+#error "SW_TIMER_POOL_SIZE is too big"
+#endif
+
+/**
+ * @brief Timer pool slot type.
+ */
+typedef struct SW_TIMER_POOL_SLOT
+{
+	// A timer buffer
+	sw_timer_buffer_t buffer;
+
+	// A slot generation, odd while the slot is allocated
+	uint16_t generation;
+
+	// An index of the next free slot
+	uint16_t next_free;
+} sw_timer_pool_slot_t;
+
+/**
+ * @brief Timer pool slots.
+ */
+static sw_timer_pool_slot_t slots[SW_TIMER_POOL_SIZE];
+
+/**
+ * @brief Index of the first free slot, SW_TIMER_POOL_SIZE if there are no
+ * free slots.
+ */
+static uint16_t first_free = 0;
+
+/**
+ * @brief Number of slots ever linked to the free list.
+ */
+static uint16_t initialized = 0;
+
+/**
+ * @brief Returns allocated slot the id refers to.
+ *
+ * @param id The timer id.
+ *
+ * @return The pointer to slot or NULL if the id is stale or invalid.
+ */
+static sw_timer_pool_slot_t *sw_timer_pool_slot(sw_timer_id_t id);
+
+sw_timer_id_t sw_timer_pool_create(
+		uint32_t period,
+		sw_timer_mode_t mode,
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg)
+{
+	sw_timer_pool_slot_t *slot;
+	uint16_t index;
+
+	/* Slots are linked to the free list on first use, so the pool needs
+	 * no initialization call */
+	if (initialized < SW_TIMER_POOL_SIZE) {
+		slots[initialized].next_free = (uint16_t) (initialized + 1);
+		initialized++;
+	}
+
+	if (first_free >= SW_TIMER_POOL_SIZE)
+		return SW_TIMER_ID_NONE;
+
+	index = first_free;
+	slot = &slots[index];
+
+	first_free = slot->next_free;
+	slot->generation++;
+
+	sw_timer_create(period, mode, callback, arg, &slot->buffer);
+
+	return ((sw_timer_id_t) slot->generation << SW_TIMER_POOL_INDEX_BITS) | index;
+}
+
+sw_timer_handle_t sw_timer_pool_get(sw_timer_id_t id)
+{
+	sw_timer_pool_slot_t *slot = sw_timer_pool_slot(id);
+
+	return (slot != NULL) ? (sw_timer_handle_t) &slot->buffer : NULL;
+}
+
+sw_timer_status_t sw_timer_pool_stop(sw_timer_id_t id)
+{
+	sw_timer_pool_slot_t *slot = sw_timer_pool_slot(id);
+
+	if (slot == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_STALE;
+
+	return sw_timer_stop(&slot->buffer);
+}
+
+sw_timer_status_t sw_timer_pool_release(sw_timer_id_t id)
+{
+	sw_timer_pool_slot_t *slot = sw_timer_pool_slot(id);
+
+	if (slot == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_STALE;
+
+	sw_timer_stop(&slot->buffer);
+
+	/* Even generation marks the slot free, all ids of it become stale */
+	slot->generation++;
+	slot->next_free = first_free;
+
+	first_free = (uint16_t) (id & SW_TIMER_POOL_INDEX_MASK);
+
+	return SW_TIMER_STATUS_OK;
+}
+
+static sw_timer_pool_slot_t *sw_timer_pool_slot(sw_timer_id_t id)
+{
+	uint32_t index = id & SW_TIMER_POOL_INDEX_MASK;
+	uint16_t generation = (uint16_t) (id >> SW_TIMER_POOL_INDEX_BITS);
+
+	if ((index >= SW_TIMER_POOL_SIZE) || ((generation & 1) == 0) || (slots[index].generation != generation))
+		return NULL;
+
+	return &slots[index];
+}
+
+#endif /* SW_TIMER_POOL_SIZE > 0 */
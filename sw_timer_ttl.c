@@ -0,0 +1,317 @@
+#include <assert.h>
+
+#include "sw_timer.h"
+#include "sw_timer_hash.h"
+
+#if SW_TIMER_TTL_BUCKETS > 0
+
+#if (SW_TIMER_TTL_BUCKETS & (SW_TIMER_TTL_BUCKETS - 1)) != 0
+#error "SW_TIMER_TTL_BUCKETS must be power of two"
+#endif
+
+/**
+ * @brief TTL map entry type.
+ */
+typedef struct SW_TIMER_TTL_ENTRY
+{
+	// An entry key
+	uint64_t key;
+
+	// A pointer to the entry value
+	void *value;
+
+	// A pointer to the next entry in the hash bucket
+	struct SW_TIMER_TTL_ENTRY *hash_next;
+
+	// A pointer to the next entry in the wheel slot
+	struct SW_TIMER_TTL_ENTRY *wheel_next;
+
+	// A pointer to the previous entry in the wheel slot
+	struct SW_TIMER_TTL_ENTRY *wheel_prev;
+
+	// An expiry time in the map time
+	uint32_t expiry;
+
+	// A wheel slot index
+	uint32_t slot;
+} sw_timer_ttl_entry_t;
+
+/**
+ * @brief Hash buckets, each bucket is singly linked list.
+ */
+static sw_timer_ttl_entry_t *buckets[SW_TIMER_TTL_BUCKETS];
+
+/**
+ * @brief Wheel slots, each slot is unsorted doubly linked list of entries
+ * that expire within one resolution interval of some wheel turn.
+ */
+static sw_timer_ttl_entry_t *slots[SW_TIMER_TTL_SLOTS];
+
+/**
+ * @brief Number of entries.
+ */
+static uint32_t count = 0;
+
+/**
+ * @brief Map time of the last wheel step, it wraps like the timer time.
+ */
+static uint32_t base = 0;
+
+/**
+ * @brief Wheel slot of the last wheel step, it advances by one slot per step
+ * and wraps with the wheel, so slots do not depend on the absolute map time.
+ */
+static uint32_t step = 0;
+
+/**
+ * @brief Timer buffer of the wheel timer.
+ */
+static sw_timer_buffer_t wheel_timer_buffer;
+
+/**
+ * @brief The wheel timer, it is running while the map is not empty.
+ */
+static sw_timer_handle_t wheel_timer = NULL;
+
+/**
+ * @brief Eviction callback.
+ */
+static sw_timer_ttl_evict_func_t evict = NULL;
+
+/**
+ * @brief Returns hash bucket of the key.
+ *
+ * @param key The entry key.
+ *
+ * @return The pointer to bucket.
+ */
+static sw_timer_ttl_entry_t **sw_timer_ttl_bucket(uint64_t key);
+
+/**
+ * @brief Returns the map time.
+ *
+ * @return The time of the last wheel step plus time passed from it.
+ */
+static uint32_t sw_timer_ttl_now(void);
+
+/**
+ * @brief Removes entry from the hash bucket and the wheel slot.
+ *
+ * @param link The pointer to the bucket link to the entry.
+ */
+static void sw_timer_ttl_unlink(sw_timer_ttl_entry_t **link);
+
+/**
+ * @brief Wheel timer callback, evicts entries of the next slot.
+ *
+ * @param arg Not used.
+ */
+static void sw_timer_ttl_step(void *arg);
+
+void sw_timer_ttl_register_evict_callback(sw_timer_ttl_evict_func_t callback)
+{
+	evict = callback;
+}
+
+sw_timer_status_t sw_timer_ttl_put(uint64_t key, void *value, uint32_t ttl, sw_timer_ttl_entry_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_ttl_entry_t) == sizeof(sw_timer_ttl_entry_buffer_t));
+
+	sw_timer_ttl_entry_t *entry = (sw_timer_ttl_entry_t *) buffer;
+	sw_timer_ttl_entry_t **bucket = sw_timer_ttl_bucket(key);
+	sw_timer_ttl_entry_t **link = bucket;
+	sw_timer_ttl_entry_t **slot;
+	sw_timer_status_t status = SW_TIMER_STATUS_OK;
+	uint32_t steps;
+
+	if (entry == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (ttl >= 0x80000000)
+		ttl = 0x7fffffff;
+
+	/* An entry with the same key is replaced */
+	while (*link != NULL) {
+		if ((*link)->key == key) {
+			sw_timer_ttl_unlink(link);
+
+			break;
+		}
+
+		link = &(*link)->hash_next;
+	}
+
+	if (count == 0) {
+		if (wheel_timer == NULL)
+			wheel_timer = sw_timer_create(SW_TIMER_TTL_RESOLUTION, SW_TIMER_MODE_REPEATING,
+					(sw_timer_func_ptr_t) sw_timer_ttl_step, NULL, &wheel_timer_buffer);
+
+		status = sw_timer_start(wheel_timer);
+
+		if (status != SW_TIMER_STATUS_OK)
+			return status;
+	}
+
+	entry->key = key;
+	entry->value = value;
+	entry->expiry = sw_timer_ttl_now() + ttl;
+
+	entry->hash_next = *bucket;
+	*bucket = entry;
+
+	/* The slot is the one stepped to at the first wheel step not earlier
+	 * than the expiry, counted from the last step, so the map time can
+	 * wrap, and the slot of the last step is not stepped to again */
+	steps = (entry->expiry - base + SW_TIMER_TTL_RESOLUTION - 1) / SW_TIMER_TTL_RESOLUTION;
+
+	if (steps == 0)
+		steps = 1;
+
+	entry->slot = (step + steps) % SW_TIMER_TTL_SLOTS;
+
+	slot = &slots[entry->slot];
+
+	entry->wheel_prev = NULL;
+	entry->wheel_next = *slot;
+
+	if (*slot != NULL)
+		(*slot)->wheel_prev = entry;
+
+	*slot = entry;
+
+	count++;
+
+	return status;
+}
+
+void *sw_timer_ttl_get(uint64_t key)
+{
+	sw_timer_ttl_entry_t **link = sw_timer_ttl_bucket(key);
+
+	while (*link != NULL) {
+		sw_timer_ttl_entry_t *entry = *link;
+
+		if (entry->key == key) {
+			/* Lazy expiry, the entry could expire between wheel steps */
+			if ((int32_t) (entry->expiry - sw_timer_ttl_now()) <= 0) {
+				sw_timer_ttl_unlink(link);
+
+				if (evict != NULL)
+					evict(entry->key, entry->value);
+
+				return NULL;
+			}
+
+			return entry->value;
+		}
+
+		link = &entry->hash_next;
+	}
+
+	return NULL;
+}
+
+sw_timer_status_t sw_timer_ttl_remove(uint64_t key)
+{
+	sw_timer_ttl_entry_t **link = sw_timer_ttl_bucket(key);
+
+	while (*link != NULL) {
+		if ((*link)->key == key) {
+			sw_timer_ttl_unlink(link);
+
+			return SW_TIMER_STATUS_OK;
+		}
+
+		link = &(*link)->hash_next;
+	}
+
+	return SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST;
+}
+
+uint32_t sw_timer_ttl_count(void)
+{
+	return count;
+}
+
+static sw_timer_ttl_entry_t **sw_timer_ttl_bucket(uint64_t key)
+{
+	return &buckets[sw_timer_hash(key) & (SW_TIMER_TTL_BUCKETS - 1)];
+}
+
+static uint32_t sw_timer_ttl_now(void)
+{
+	if (count == 0)
+		return base;
+
+	return base + SW_TIMER_TTL_RESOLUTION - sw_timer_remaining(wheel_timer);
+}
+
+static void sw_timer_ttl_unlink(sw_timer_ttl_entry_t **link)
+{
+	sw_timer_ttl_entry_t *entry = *link;
+
+	*link = entry->hash_next;
+
+	if (entry->wheel_prev != NULL)
+		entry->wheel_prev->wheel_next = entry->wheel_next;
+	else
+		slots[entry->slot] = entry->wheel_next;
+
+	if (entry->wheel_next != NULL)
+		entry->wheel_next->wheel_prev = entry->wheel_prev;
+
+	entry->hash_next = NULL;
+	entry->wheel_next = NULL;
+	entry->wheel_prev = NULL;
+
+	count--;
+
+	if ((count == 0) && (wheel_timer != NULL))
+		sw_timer_stop(wheel_timer);
+}
+
+static void sw_timer_ttl_step(void *arg)
+{
+	sw_timer_ttl_entry_t *evicted = NULL;
+	sw_timer_ttl_entry_t *entry;
+
+	(void) arg;
+
+	base += SW_TIMER_TTL_RESOLUTION;
+	step = (step + 1) % SW_TIMER_TTL_SLOTS;
+
+	entry = slots[step];
+
+	/* Entries of later wheel turns stay in the slot */
+	while (entry != NULL) {
+		sw_timer_ttl_entry_t *next = entry->wheel_next;
+
+		if ((int32_t) (entry->expiry - base) <= 0) {
+			sw_timer_ttl_entry_t **link = sw_timer_ttl_bucket(entry->key);
+
+			while (*link != entry)
+				link = &(*link)->hash_next;
+
+			sw_timer_ttl_unlink(link);
+
+			entry->wheel_next = evicted;
+			evicted = entry;
+		}
+
+		entry = next;
+	}
+
+	/* Callbacks are called after the slot is drained, evicted entries are
+	 * not in the map any more */
+	while (evicted != NULL) {
+		entry = evicted;
+		evicted = entry->wheel_next;
+
+		entry->wheel_next = NULL;
+
+		if (evict != NULL)
+			evict(entry->key, entry->value);
+	}
+}
+
+#endif /* SW_TIMER_TTL_BUCKETS > 0 */
@@ -0,0 +1,329 @@
+#include <assert.h>
+
+#include "sw_timer.h"
+
+#if SW_TIMER_WALL > 0
+
+/**
+ * @brief Maximum wakeup timer delay in seconds, longer waits are split.
+ */
+#define SW_TIMER_WALL_MAX_DELAY (0x7fffffff / SW_TIMER_TICK_RATE_HZ)
+
+/**
+ * @brief Wall-clock timer type.
+ */
+typedef struct SW_TIMER_WALL_TIMER
+{
+	// A pointer to the next timer of the queue
+	struct SW_TIMER_WALL_TIMER *next;
+
+	// A pointer to the previous timer of the queue
+	struct SW_TIMER_WALL_TIMER *prev;
+
+	// A pointer to the callback function
+	sw_timer_func_ptr_t callback;
+
+	// A pointer to the callback function argument
+	sw_timer_arg_ptr_t arg;
+
+	// The expiry wall time, in seconds
+	uint32_t expiry;
+
+	// The timer period in seconds, 0 for single-shot timer
+	uint32_t period;
+
+	// Non-zero value if the timer is queued
+	uint32_t running;
+
+	// Non-zero value if a clock step makes the timer due at once
+	uint32_t refind;
+} sw_timer_wall_t;
+
+/**
+ * @brief The head of doubly linked list sorted by expiry wall time.
+ */
+static sw_timer_wall_t *head = NULL;
+
+/**
+ * @brief The wakeup timer buffer.
+ */
+static sw_timer_buffer_t wakeup_timer_buffer;
+
+/**
+ * @brief The wakeup timer.
+ */
+static sw_timer_handle_t wakeup_timer = NULL;
+
+/**
+ * @brief Clock callback.
+ */
+static sw_timer_clock_func_t clock_callback = NULL;
+
+/**
+ * @brief Links timer to the queue by its expiry wall time.
+ *
+ * @param timer The pointer to timer.
+ */
+static void sw_timer_wall_link(sw_timer_wall_t *timer);
+
+/**
+ * @brief Unlinks timer from the queue.
+ *
+ * @param timer The pointer to timer.
+ */
+static void sw_timer_wall_unlink(sw_timer_wall_t *timer);
+
+/**
+ * @brief Arms the wakeup timer for the first timer of the queue, up to the
+ * maximum delay, or stops it if the queue is empty.
+ *
+ * @param now The wall time, in seconds.
+ */
+static void sw_timer_wall_arm(uint32_t now);
+
+/**
+ * @brief Wakeup timer callback, expires all timers due at the current wall
+ * time.
+ *
+ * @param arg Not used.
+ */
+static void sw_timer_wall_wakeup(void *arg);
+
+void sw_timer_wall_register_clock(sw_timer_clock_func_t clock_func)
+{
+	clock_callback = clock_func;
+}
+
+sw_timer_status_t sw_timer_wall_now(uint32_t *time)
+{
+	if (clock_callback == NULL)
+		return SW_TIMER_STATUS_ERROR_CLOCK_NOT_REGISTERED;
+
+	*time = clock_callback();
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_wall_handle_t sw_timer_wall_create(
+		sw_timer_func_ptr_t callback,
+		sw_timer_arg_ptr_t arg,
+		sw_timer_wall_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_wall_t) == sizeof(sw_timer_wall_buffer_t));
+
+	sw_timer_wall_t *timer = (sw_timer_wall_t *) buffer;
+
+	if (timer == NULL)
+		return NULL;
+
+	if (wakeup_timer == NULL)
+		wakeup_timer = sw_timer_create(0, SW_TIMER_MODE_SINGLE_SHOT,
+				(sw_timer_func_ptr_t) sw_timer_wall_wakeup, NULL, &wakeup_timer_buffer);
+
+	timer->next = NULL;
+	timer->prev = NULL;
+	timer->callback = callback;
+	timer->arg = arg;
+	timer->expiry = 0;
+	timer->period = 0;
+	timer->running = 0;
+	timer->refind = 0;
+
+	return timer;
+}
+
+sw_timer_status_t sw_timer_wall_start_at(sw_timer_wall_handle_t handle, uint32_t time, uint32_t period)
+{
+	sw_timer_wall_t *timer = (sw_timer_wall_t *) handle;
+
+	if (timer == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (clock_callback == NULL)
+		return SW_TIMER_STATUS_ERROR_CLOCK_NOT_REGISTERED;
+
+	if (timer->running)
+		sw_timer_wall_unlink(timer);
+
+	timer->expiry = time;
+	timer->period = period;
+
+	sw_timer_wall_link(timer);
+
+	/* Only a new first timer changes the wakeup time */
+	if (head == timer)
+		sw_timer_wall_arm(clock_callback());
+
+	return SW_TIMER_STATUS_OK;
+}
+
+sw_timer_status_t sw_timer_wall_stop(sw_timer_wall_handle_t handle)
+{
+	sw_timer_wall_t *timer = (sw_timer_wall_t *) handle;
+
+	if (timer == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	if (timer->running) {
+		sw_timer_wall_unlink(timer);
+
+		/* An early wakeup finds nothing due and rearms, so the wakeup timer
+		 * is only stopped when the queue is empty */
+		if (head == NULL)
+			sw_timer_stop(wakeup_timer);
+	}
+
+	return SW_TIMER_STATUS_OK;
+}
+
+uint32_t sw_timer_wall_expiry(sw_timer_wall_handle_t handle)
+{
+	return ((sw_timer_wall_t *) handle)->expiry;
+}
+
+sw_timer_status_t sw_timer_wall_refind_on_step(sw_timer_wall_handle_t handle, uint32_t enable)
+{
+	sw_timer_wall_t *timer = (sw_timer_wall_t *) handle;
+
+	if (timer == NULL)
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	timer->refind = (enable != 0) ? 1 : 0;
+
+	return SW_TIMER_STATUS_OK;
+}
+
+void sw_timer_wall_clock_changed(void)
+{
+	sw_timer_wall_t *rebased = NULL;
+	sw_timer_wall_t *timer = head;
+	uint32_t now;
+
+	if ((clock_callback == NULL) || (head == NULL))
+		return;
+
+	now = clock_callback();
+
+	/* Expiries are absolute wall times, so they stay valid after a step. Only
+	 * repeating timers left more than one period ahead by a backward step are
+	 * moved back by whole periods, keeping their phase. */
+	while (timer) {
+		sw_timer_wall_t *next = timer->next;
+
+		if ((timer->period != 0) && ((int32_t) (timer->expiry - now) > (int32_t) timer->period)) {
+			sw_timer_wall_unlink(timer);
+
+			timer->expiry -= ((timer->expiry - now - 1) / timer->period) * timer->period;
+			timer->next = rebased;
+			rebased = timer;
+		}
+		/* Timers that find their expiry from the wall time are due at once,
+		 * their callbacks find it again from the new wall time */
+		else if (timer->refind) {
+			sw_timer_wall_unlink(timer);
+
+			timer->expiry = now;
+			timer->next = rebased;
+			rebased = timer;
+		}
+
+		timer = next;
+	}
+
+	while (rebased) {
+		timer = rebased;
+		rebased = timer->next;
+
+		sw_timer_wall_link(timer);
+	}
+
+	sw_timer_wall_arm(now);
+}
+
+static void sw_timer_wall_link(sw_timer_wall_t *timer)
+{
+	sw_timer_wall_t **link = &head;
+	sw_timer_wall_t *prev = NULL;
+
+	/* Timers with equal expiry keep start order */
+	while ((*link != NULL) && ((int32_t) ((*link)->expiry - timer->expiry) <= 0)) {
+		prev = *link;
+		link = &prev->next;
+	}
+
+	timer->prev = prev;
+	timer->next = *link;
+
+	if (*link != NULL)
+		(*link)->prev = timer;
+
+	*link = timer;
+
+	timer->running = 1;
+}
+
+static void sw_timer_wall_unlink(sw_timer_wall_t *timer)
+{
+	if (timer->prev != NULL)
+		timer->prev->next = timer->next;
+	else
+		head = timer->next;
+
+	if (timer->next != NULL)
+		timer->next->prev = timer->prev;
+
+	timer->next = NULL;
+	timer->prev = NULL;
+	timer->running = 0;
+}
+
+static void sw_timer_wall_arm(uint32_t now)
+{
+	int32_t delay;
+
+	if (head == NULL) {
+		sw_timer_stop(wakeup_timer);
+
+		return;
+	}
+
+	delay = (int32_t) (head->expiry - now);
+
+	/* Due timers are expired by the wakeup timer at the next tick, so
+	 * callbacks are always called from the interrupt handler */
+	if (delay <= 0)
+		sw_timer_reschedule(wakeup_timer, 1);
+	else if ((uint32_t) delay > SW_TIMER_WALL_MAX_DELAY)
+		sw_timer_reschedule(wakeup_timer, SW_TIMER_CONV_SECONDS_TO_TICKS(SW_TIMER_WALL_MAX_DELAY));
+	else
+		sw_timer_reschedule(wakeup_timer, SW_TIMER_CONV_SECONDS_TO_TICKS((uint32_t) delay));
+}
+
+static void sw_timer_wall_wakeup(void *arg)
+{
+	uint32_t now = clock_callback();
+
+	(void) arg;
+
+	while ((head != NULL) && ((int32_t) (head->expiry - now) <= 0)) {
+		sw_timer_wall_t *timer = head;
+		void (*callback)(void *arg) = timer->callback;
+
+		sw_timer_wall_unlink(timer);
+
+		/* Missed periods are skipped, the timer keeps its phase */
+		if (timer->period != 0) {
+			timer->expiry += ((now - timer->expiry) / timer->period + 1) * timer->period;
+
+			sw_timer_wall_link(timer);
+		}
+
+		if (callback != NULL)
+			callback(timer->arg);
+	}
+
+	/* Callbacks could restart or stop timers, the wakeup follows the queue */
+	sw_timer_wall_arm(now);
+}
+
+#endif /* SW_TIMER_WALL > 0 */
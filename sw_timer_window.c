@@ -0,0 +1,222 @@
+#include <assert.h>
+#include <string.h>
+
+#include "sw_timer.h"
+
+#if SW_TIMER_WINDOW_CLOCKS > 0
+
+/**
+ * @brief Rotation clock type, shared by all counters of one bucket width.
+ */
+typedef struct SW_TIMER_WINDOW_CLOCK
+{
+	// A timer buffer of the rotation timer
+	sw_timer_buffer_t timer_buffer;
+
+	// The rotation timer, it is running while the clock has counters
+	sw_timer_handle_t timer;
+
+	// A bucket width in ticks, 0 if the clock is not used
+	uint32_t width;
+
+	// Number of counters using the clock
+	uint32_t users;
+
+	// Number of rotations, it wraps around
+	volatile uint32_t rotations;
+} sw_timer_window_clock_t;
+
+/**
+ * @brief Sliding window counter type.
+ */
+typedef struct SW_TIMER_WINDOW
+{
+	// A pointer to the rotation clock
+	sw_timer_window_clock_t *clock;
+
+	// Number of clock rotations the buckets are rotated to
+	uint32_t rotations;
+
+	// An index of the current bucket
+	uint32_t head;
+
+	// Number of buckets in the window
+	uint32_t length;
+
+	// A sum of all buckets
+	uint32_t total;
+
+	// Bucket counts
+	uint32_t buckets[SW_TIMER_WINDOW_BUCKETS];
+} sw_timer_window_t;
+
+/**
+ * @brief Rotation clocks.
+ */
+static sw_timer_window_clock_t clocks[SW_TIMER_WINDOW_CLOCKS];
+
+/**
+ * @brief Rotation timer callback.
+ *
+ * @param clock The pointer to clock.
+ */
+static void sw_timer_window_tick(sw_timer_window_clock_t *clock);
+
+/**
+ * @brief Rotates counter buckets to the clock rotations, buckets rotated
+ * out of the window are cleared.
+ *
+ * @param window The pointer to counter.
+ */
+static void sw_timer_window_rotate(sw_timer_window_t *window);
+
+sw_timer_window_handle_t sw_timer_window_create(uint32_t width, uint32_t length, sw_timer_window_buffer_t *buffer)
+{
+	assert(sizeof(sw_timer_window_t) == sizeof(sw_timer_window_buffer_t));
+
+	sw_timer_window_t *window = (sw_timer_window_t *) buffer;
+	sw_timer_window_clock_t *clock = NULL;
+	uint32_t i;
+
+	if ((window == NULL) || (width == 0) || (length == 0) || (length > SW_TIMER_WINDOW_BUCKETS))
+		return NULL;
+
+	/* Counters of one width share the clock, a free clock is taken for a new
+	 * width */
+	for (i = 0; i < SW_TIMER_WINDOW_CLOCKS; i++) {
+		if (clocks[i].width == width) {
+			clock = &clocks[i];
+
+			break;
+		}
+
+		if ((clock == NULL) && (clocks[i].width == 0))
+			clock = &clocks[i];
+	}
+
+	if (clock == NULL)
+		return NULL;
+
+	if (clock->users == 0) {
+		clock->width = width;
+		clock->timer = sw_timer_create(width, SW_TIMER_MODE_REPEATING,
+				(sw_timer_func_ptr_t) sw_timer_window_tick, clock, &clock->timer_buffer);
+
+		if (sw_timer_start(clock->timer) != SW_TIMER_STATUS_OK) {
+			clock->width = 0;
+
+			return NULL;
+		}
+	}
+
+	clock->users++;
+
+	window->clock = clock;
+	window->rotations = clock->rotations;
+	window->head = 0;
+	window->length = length;
+	window->total = 0;
+
+	memset(window->buckets, 0, sizeof(window->buckets));
+
+	return window;
+}
+
+sw_timer_status_t sw_timer_window_delete(sw_timer_window_handle_t handle)
+{
+	sw_timer_window_t *window = (sw_timer_window_t *) handle;
+	sw_timer_window_clock_t *clock;
+
+	if ((window == NULL) || (window->clock == NULL))
+		return SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST;
+
+	clock = window->clock;
+	window->clock = NULL;
+
+	if (--clock->users == 0) {
+		sw_timer_stop(clock->timer);
+
+		clock->width = 0;
+	}
+
+	return SW_TIMER_STATUS_OK;
+}
+
+void sw_timer_window_add(sw_timer_window_handle_t handle, uint32_t value)
+{
+	sw_timer_window_t *window = (sw_timer_window_t *) handle;
+
+	sw_timer_window_rotate(window);
+
+	window->buckets[window->head] += value;
+	window->total += value;
+}
+
+uint32_t sw_timer_window_sum(sw_timer_window_handle_t handle)
+{
+	sw_timer_window_t *window = (sw_timer_window_t *) handle;
+
+	sw_timer_window_rotate(window);
+
+	return window->total;
+}
+
+uint32_t sw_timer_window_sum_last(sw_timer_window_handle_t handle, uint32_t length)
+{
+	sw_timer_window_t *window = (sw_timer_window_t *) handle;
+	uint32_t index;
+	uint32_t sum = 0;
+
+	sw_timer_window_rotate(window);
+
+	if (length >= window->length)
+		return window->total;
+
+	index = window->head;
+
+	while (length--) {
+		sum += window->buckets[index];
+
+		index = (index != 0) ? (index - 1) : (window->length - 1);
+	}
+
+	return sum;
+}
+
+static void sw_timer_window_tick(sw_timer_window_clock_t *clock)
+{
+	clock->rotations++;
+}
+
+static void sw_timer_window_rotate(sw_timer_window_t *window)
+{
+	uint32_t steps;
+
+	/* Every counter function rotates on entry, a deleted counter has no
+	 * clock and its handle must not be used */
+	assert(window->clock != NULL);
+
+	steps = window->clock->rotations - window->rotations;
+
+	if (steps == 0)
+		return;
+
+	window->rotations += steps;
+
+	if (steps >= window->length) {
+		memset(window->buckets, 0, window->length * sizeof(window->buckets[0]));
+
+		window->total = 0;
+
+		return;
+	}
+
+	while (steps--) {
+		window->head = (window->head + 1 != window->length) ? (window->head + 1) : 0;
+
+		window->total -= window->buckets[window->head];
+		window->buckets[window->head] = 0;
+	}
+}
+
+#endif /* SW_TIMER_WINDOW_CLOCKS > 0 */
@@ -0,0 +1,116 @@
+#ifndef SIM_TIMER_H
+#define SIM_TIMER_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "sw_timer.h"
+
+/**
+ * @brief Simulated physical timer shared by the tests.
+ *
+ * The physical timer counts down one tick per sim_timer_tick() and calls
+ * sw_timer_interrupt_handler() when it reaches 0, sim_clock counts all
+ * ticks from the test start.
+ */
+
+/**
+ * @brief Checks the condition and counts the failure, the test goes on.
+ */
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			sim_failures++; \
+		} \
+	} while (0)
+
+/**
+ * @brief Ticks left to the physical timer interrupt, 0 if it is stopped.
+ */
+static uint32_t sim_remaining = 0;
+
+/**
+ * @brief Ticks from the test start.
+ */
+static uint64_t sim_clock = 0;
+
+/**
+ * @brief Number of failed checks.
+ */
+static uint32_t sim_failures = 0;
+
+static inline void sim_timer_set(uint32_t delay)
+{
+	sim_remaining = delay;
+}
+
+static inline uint32_t sim_timer_get(void)
+{
+	return sim_remaining;
+}
+
+/**
+ * @brief Registers the simulated physical timer.
+ */
+static inline void sim_timer_init(void)
+{
+	sw_timer_register_physical_sw_timer_callbacks(sim_timer_set, sim_timer_get);
+}
+
+/**
+ * @brief Advances the time by one tick, the interrupt handler sees
+ * sim_clock equal to the expiry.
+ */
+static inline void sim_timer_tick(void)
+{
+	sim_clock++;
+
+	if ((sim_remaining != 0) && (--sim_remaining == 0))
+		sw_timer_interrupt_handler();
+}
+
+/**
+ * @brief Advances the time by ticks.
+ *
+ * @param ticks The number of ticks.
+ */
+static inline void sim_timer_run(uint32_t ticks)
+{
+	while (ticks-- != 0)
+		sim_timer_tick();
+}
+
+/**
+ * @brief Advances the time to the next interrupt at once.
+ *
+ * @return Non-zero value if the physical timer was running.
+ */
+static inline int sim_timer_jump(void)
+{
+	if (sim_remaining == 0)
+		return 0;
+
+	sim_clock += sim_remaining - 1;
+	sim_remaining = 1;
+
+	sim_timer_tick();
+
+	return 1;
+}
+
+/**
+ * @brief Prints the test result.
+ *
+ * @param name The test name.
+ *
+ * @return The process exit code.
+ */
+static inline int sim_timer_result(const char *name)
+{
+	printf("%s: %s, %u failed checks\n", name, (sim_failures == 0) ? "ok" : "FAILED", sim_failures);
+
+	return sim_failures != 0;
+}
+
+#endif /* SIM_TIMER_H */
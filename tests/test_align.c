@@ -0,0 +1,96 @@
+#include "sim_timer.h"
+
+/**
+ * @brief Aligned repeating timer behavior test.
+ *
+ * Aligned timers of one period started or updated at different times expire
+ * on the same ticks. The grid is kept when the 32-bit time wraps, the period
+ * does not divide 2^32, so a grid of the 32-bit time would jump there.
+ */
+
+#define PERIOD 1000
+
+static sw_timer_buffer_t buffers[2];
+
+static sw_timer_handle_t timers[2];
+
+static uint64_t last[2];
+
+static uint32_t fired = 0;
+
+static uint32_t together = 0;
+
+static void expired(void *arg)
+{
+	uint32_t i = (uint32_t) (uintptr_t) arg;
+
+	last[i] = sim_clock;
+
+	/* Timers of one interrupt are called in any order, so phases are
+	 * compared */
+	if (i == 1) {
+		fired++;
+		together += ((sim_clock - last[0]) % PERIOD == 0) ? 1 : 0;
+	}
+}
+
+/**
+ * @brief Runs ten periods, returns non-zero value if the second timer
+ * expired with the first one every time.
+ */
+static int run_together(void)
+{
+	fired = 0;
+	together = 0;
+
+	sim_timer_run(10 * PERIOD);
+
+	return (fired >= 9) && (together == fired);
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	sim_timer_init();
+
+	for (i = 0; i < 2; i++)
+		timers[i] = sw_timer_create(PERIOD, SW_TIMER_MODE_REPEATING_ALIGNED, (sw_timer_func_ptr_t) expired,
+				(void *) (uintptr_t) i, &buffers[i]);
+
+	sw_timer_start(timers[0]);
+	sim_timer_run(537);
+
+	/* A start moves the first expiry to the grid */
+	sw_timer_start(timers[1]);
+
+	CHECK(run_together());
+
+	/* So does an update of a running timer */
+	sw_timer_update(timers[1], PERIOD, SW_TIMER_MODE_REPEATING, (sw_timer_func_ptr_t) expired, (void *) (uintptr_t) 1);
+	sim_timer_run(123);
+
+	CHECK(!run_together());
+
+	sw_timer_update(timers[1], PERIOD, SW_TIMER_MODE_REPEATING_ALIGNED, (sw_timer_func_ptr_t) expired, (void *) (uintptr_t) 1);
+
+	CHECK(run_together());
+
+	/* The 32-bit time wraps while the first timer runs */
+	sw_timer_stop(timers[1]);
+
+	while (sim_clock < 0x100000000ull + 5 * PERIOD)
+		sim_timer_jump();
+
+	sim_timer_run(77);
+	sw_timer_start(timers[1]);
+
+	CHECK(run_together());
+
+	sw_timer_stop(timers[0]);
+	sw_timer_stop(timers[1]);
+
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("align");
+}
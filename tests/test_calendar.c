@@ -0,0 +1,272 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Calendar schedule behavior test.
+ *
+ * Next fire times of cron expressions from random start times are checked
+ * against a search over gmtime() fields, schedules must fire at
+ * them, and the next fire time is found again after wall clock steps.
+ */
+
+#define STARTS 20
+
+#define FIRES 5
+
+// Wall time at the test clock start, in seconds
+static uint32_t wall_base = 0;
+
+// Fields of the expression under test
+static char fields[5][64];
+
+static uint32_t expected_fire = 0;
+
+static uint32_t fired = 0;
+
+static uint32_t wall_clock(void)
+{
+	return wall_base + (uint32_t) (sim_clock / SW_TIMER_TICK_RATE_HZ);
+}
+
+static void fire(void *arg)
+{
+	(void) arg;
+
+	CHECK(wall_clock() == expected_fire);
+
+	fired++;
+}
+
+/**
+ * @brief Reference field match, any value of "*" is flagged.
+ */
+static int field_matches(const char *field, int value, int min, int max, int *any)
+{
+	char buffer[64];
+	char *token;
+	int match = 0;
+
+	strcpy(buffer, field);
+
+	*any = (strcmp(field, "*") == 0);
+
+	for (token = strtok(buffer, ","); token != NULL; token = strtok(NULL, ",")) {
+		char *slash = strchr(token, '/');
+		char *dash;
+		int first = min;
+		int last = max;
+		int step = 1;
+		int v;
+
+		if (slash != NULL) {
+			step = atoi(slash + 1);
+			*slash = '\0';
+		}
+
+		if (strcmp(token, "*") != 0) {
+			first = atoi(token);
+			dash = strchr(token, '-');
+			last = (dash != NULL) ? atoi(dash + 1) : ((slash != NULL) ? max : first);
+		}
+
+		/* Both 0 and 7 are Sunday */
+		for (v = first; v <= last; v += step)
+			if ((v == value) || ((max == 7) && (v == 7) && (value == 0)))
+				match = 1;
+	}
+
+	return match;
+}
+
+static int day_matches(const struct tm *tm)
+{
+	int any_day;
+	int any_weekday;
+	int any;
+	int day;
+	int weekday;
+
+	if (!field_matches(fields[3], tm->tm_mon + 1, 1, 12, &any))
+		return 0;
+
+	day = field_matches(fields[2], tm->tm_mday, 1, 31, &any_day);
+	weekday = field_matches(fields[4], tm->tm_wday, 0, 7, &any_weekday);
+
+	/* Restricted day fields match either of them */
+	if (any_day && any_weekday)
+		return 1;
+
+	if (any_day)
+		return weekday;
+
+	if (any_weekday)
+		return day;
+
+	return day || weekday;
+}
+
+static uint32_t reference_next(uint32_t now, uint32_t limit)
+{
+	uint32_t time = now - (now % 60) + 60;
+	int any;
+
+	/* Days and hours that do not match are skipped whole */
+	while (time < limit) {
+		time_t t = (time_t) time;
+		struct tm *tm = gmtime(&t);
+
+		if (!day_matches(tm))
+			time += 86400 - (time % 86400);
+		else if (!field_matches(fields[1], tm->tm_hour, 0, 23, &any))
+			time += 3600 - (time % 3600);
+		else if (!field_matches(fields[0], tm->tm_min, 0, 59, &any))
+			time += 60;
+		else
+			return time;
+	}
+
+	return 0;
+}
+
+static void wait_fire(void)
+{
+	uint32_t before = fired;
+
+	while ((fired == before) && sim_timer_jump())
+		;
+
+	CHECK(fired == before + 1);
+}
+
+static void test_expression(const char *expression)
+{
+	static sw_timer_calendar_buffer_t buffer;
+	sw_timer_calendar_handle_t schedule;
+	uint32_t i;
+	uint32_t f;
+
+	sscanf(expression, "%63s %63s %63s %63s %63s", fields[0], fields[1], fields[2], fields[3], fields[4]);
+
+	schedule = sw_timer_calendar_create(expression, (sw_timer_func_ptr_t) fire, NULL, &buffer);
+
+	CHECK(schedule != NULL);
+
+	if (schedule == NULL)
+		return;
+
+	for (i = 0; i < STARTS; i++) {
+		/* Random start from 2000 to 2040 */
+		uint32_t limit;
+		uint32_t next;
+		sw_timer_status_t status;
+
+		wall_base = 946684800u + ((uint32_t) rand() % (40 * 365)) * 86400u + (uint32_t) rand() % 86400;
+		sim_clock = 0;
+		limit = wall_base + 9 * 366 * 86400u;
+
+		status = sw_timer_calendar_start(schedule);
+		next = reference_next(wall_base, limit);
+
+		if (next == 0) {
+			CHECK(status == SW_TIMER_STATUS_ERROR_SCHEDULE_NEVER_FIRES);
+
+			continue;
+		}
+
+		CHECK(status == SW_TIMER_STATUS_OK);
+		CHECK(sw_timer_calendar_next(schedule) == next);
+
+		/* Rare fire times can be beyond the reference search */
+		for (f = 0; (f < FIRES) && (next != 0); f++) {
+			expected_fire = next;
+
+			wait_fire();
+
+			next = reference_next(wall_clock(), limit + 400 * 86400u);
+
+			CHECK((next == 0) || (sw_timer_calendar_next(schedule) == next));
+		}
+
+		sw_timer_calendar_stop(schedule);
+	}
+}
+
+static void test_clock_steps(void)
+{
+	static sw_timer_calendar_buffer_t buffer;
+	sw_timer_calendar_handle_t schedule;
+	uint32_t midnight = 1700006400u;
+	uint32_t before;
+
+	strcpy(fields[0], "0");
+	strcpy(fields[1], "12");
+	strcpy(fields[2], "*");
+	strcpy(fields[3], "*");
+	strcpy(fields[4], "*");
+
+	schedule = sw_timer_calendar_create("0 12 * * *", (sw_timer_func_ptr_t) fire, NULL, &buffer);
+
+	/* Started at 13:00, fires tomorrow */
+	wall_base = midnight + 13 * 3600;
+	sim_clock = 0;
+
+	CHECK(sw_timer_calendar_start(schedule) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_calendar_next(schedule) == midnight + 86400 + 12 * 3600);
+
+	/* Stepped back to 11:00, fires today without firing for the step */
+	before = fired;
+	wall_base -= 2 * 3600;
+	sw_timer_wall_clock_changed();
+	sim_timer_jump();
+
+	CHECK(fired == before);
+	CHECK(sw_timer_calendar_next(schedule) == midnight + 12 * 3600);
+
+	expected_fire = midnight + 12 * 3600;
+	wait_fire();
+
+	/* Stepped forward past two fire times, fires once */
+	wall_base += 2 * 86400;
+	expected_fire = wall_clock();
+	sw_timer_wall_clock_changed();
+	wait_fire();
+
+	CHECK(sw_timer_calendar_next(schedule) == midnight + 3 * 86400 + 12 * 3600);
+
+	sw_timer_calendar_stop(schedule);
+
+	CHECK(sim_remaining == 0);
+}
+
+int main(void)
+{
+	static const char *expressions[] = {
+		"* * * * *", "0 0 29 2 *", "0 12 13 * 5", "*/7 3-5,22 * * 1-5", "5 4 31 * *",
+		"0 0 * * 0", "0 0 * * 7", "30 23 1,15 1/3 *", "0 0 30 2 *", "59 23 31 12 *",
+		"1-59/10 */6 10-20/5 * 2,4", "0 0 1 1 *"
+	};
+	static const char *invalid[] = {
+		"", "* * * *", "60 * * * *", "* 24 * * *", "* * 0 * *", "* * * 13 *", "* * * * 8",
+		"5-3 * * * *", "*/0 * * * *", "a * * * *", "* * * * * *", "1,,2 * * * *", "1- * * * *"
+	};
+	static sw_timer_calendar_buffer_t buffer;
+	uint32_t i;
+
+	srand(5);
+
+	sim_timer_init();
+	sw_timer_wall_register_clock(wall_clock);
+
+	for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+		CHECK(sw_timer_calendar_create(invalid[i], NULL, NULL, &buffer) == NULL);
+
+	for (i = 0; i < sizeof(expressions) / sizeof(expressions[0]); i++)
+		test_expression(expressions[i]);
+
+	test_clock_steps();
+
+	return sim_timer_result("calendar");
+}
@@ -0,0 +1,163 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Deadline tree behavior test.
+ *
+ * Random starts, restarts and cancels of deadlines under random parents are
+ * checked against a model of the tree. A deadline expires at its own time or
+ * at the time of an ancestor if that is earlier, together with its whole
+ * subtree and children before parents. Cancelling or restarting a deadline
+ * cancels its subtree without callbacks.
+ */
+
+#define DEADLINES 64
+
+#define STEPS 300000
+
+#define NONE DEADLINES
+
+static sw_timer_deadline_buffer_t buffers[DEADLINES];
+
+static sw_timer_deadline_handle_t deadlines[DEADLINES];
+
+// Parent of every deadline of the model, NONE for a root
+static uint32_t parents[DEADLINES];
+
+// Own expiry time of every deadline of the model
+static int64_t expiries[DEADLINES];
+
+static uint32_t running[DEADLINES];
+
+static uint32_t fired = 0;
+
+static uint32_t cascaded = 0;
+
+/**
+ * @brief Returns expiry time of the deadline limited by its ancestors.
+ */
+static int64_t effective_expiry(uint32_t i)
+{
+	int64_t expiry = expiries[i];
+
+	for (i = parents[i]; i != NONE; i = parents[i])
+		if (expiries[i] < expiry)
+			expiry = expiries[i];
+
+	return expiry;
+}
+
+static uint32_t is_descendant(uint32_t i, uint32_t ancestor)
+{
+	for (; i != NONE; i = parents[i])
+		if (i == ancestor)
+			return 1;
+
+	return 0;
+}
+
+/**
+ * @brief Stops the deadline and its running descendants in the model.
+ */
+static void model_cancel(uint32_t ancestor)
+{
+	uint32_t i;
+
+	for (i = 0; i < DEADLINES; i++)
+		if ((i != ancestor) && running[i] && is_descendant(i, ancestor))
+			running[i] = 0;
+
+	running[ancestor] = 0;
+}
+
+static void expired(void *arg)
+{
+	uint32_t i = (uint32_t) (uintptr_t) arg;
+	uint32_t j;
+
+	CHECK(running[i]);
+	CHECK(effective_expiry(i) == (int64_t) sim_clock);
+
+	if (expiries[i] != (int64_t) sim_clock)
+		cascaded++;
+
+	/* Children are called back before their parents */
+	for (j = 0; j < DEADLINES; j++)
+		CHECK(!running[j] || (parents[j] != i));
+
+	running[i] = 0;
+	fired++;
+}
+
+int main(void)
+{
+	uint32_t i;
+	uint32_t n;
+
+	srand(13);
+
+	sim_timer_init();
+
+	for (i = 0; i < DEADLINES; i++) {
+		deadlines[i] = sw_timer_deadline_create((sw_timer_func_ptr_t) expired, (void *) (uintptr_t) i, &buffers[i]);
+		parents[i] = NONE;
+	}
+
+	for (n = 0; n < STEPS; n++) {
+		uint32_t parent = (uint32_t) rand() % (DEADLINES + 1);
+		uint32_t delay = 1 + (uint32_t) rand() % 500;
+		sw_timer_status_t status;
+
+		i = (uint32_t) rand() % DEADLINES;
+
+		switch (rand() % 16) {
+		case 0:
+		case 1:
+			status = sw_timer_deadline_start(deadlines[i], (parent != NONE) ? deadlines[parent] : NULL, delay);
+
+			if (running[i])
+				model_cancel(i);
+
+			/* The parent can be cancelled together with the restarted deadline */
+			if ((parent != NONE) && !running[parent]) {
+				CHECK(status == SW_TIMER_STATUS_ERROR_PARENT_NOT_RUNNING);
+				break;
+			}
+
+			CHECK(status == SW_TIMER_STATUS_OK);
+
+			parents[i] = parent;
+			expiries[i] = (int64_t) sim_clock + delay;
+			running[i] = 1;
+			break;
+		case 2:
+			CHECK(sw_timer_deadline_cancel(deadlines[i]) == SW_TIMER_STATUS_OK);
+
+			if (running[i])
+				model_cancel(i);
+			break;
+		default:
+			break;
+		}
+
+		sim_timer_tick();
+
+		/* Nothing is overdue */
+		for (i = 0; i < DEADLINES; i++)
+			if (running[i])
+				CHECK(effective_expiry(i) > (int64_t) sim_clock);
+	}
+
+	CHECK(fired > 0);
+	CHECK(cascaded > 0);
+
+	/* Cancelling the roots stops everything */
+	for (i = 0; i < DEADLINES; i++)
+		if (running[i] && (parents[i] == NONE))
+			sw_timer_deadline_cancel(deadlines[i]);
+
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("deadline");
+}
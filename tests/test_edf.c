@@ -0,0 +1,117 @@
+#include "sim_timer.h"
+
+/**
+ * @brief EDF scheduler behavior test.
+ *
+ * Jobs are taken in deadline order, and a job completed after its deadline
+ * is counted as a miss even if no other timer is running. No more than
+ * SW_TIMER_EDF_TASKS tasks are created, and all of them can be ready at once.
+ */
+
+static void job(void *arg)
+{
+	(void) arg;
+}
+
+int main(void)
+{
+	static sw_timer_edf_buffer_t buffers[SW_TIMER_EDF_TASKS + 1];
+	sw_timer_edf_handle_t tasks[SW_TIMER_EDF_TASKS];
+	sw_timer_edf_handle_t task;
+	uint32_t i;
+
+	sim_timer_init();
+
+	tasks[0] = sw_timer_edf_create((sw_timer_func_ptr_t) job, NULL, 300, &buffers[0]);
+	tasks[1] = sw_timer_edf_create((sw_timer_func_ptr_t) job, NULL, 100, &buffers[1]);
+	tasks[2] = sw_timer_edf_create((sw_timer_func_ptr_t) job, NULL, 200, &buffers[2]);
+
+	/* Released together, taken by deadline */
+	sw_timer_edf_release_after(tasks[0], 10);
+	sw_timer_edf_release_after(tasks[1], 10);
+	sw_timer_edf_release_after(tasks[2], 10);
+
+	CHECK(sw_timer_edf_next() == NULL);
+
+	sim_timer_run(10);
+
+	CHECK(sw_timer_edf_next() == tasks[1]);
+	CHECK(sw_timer_edf_next() == tasks[2]);
+	CHECK(sw_timer_edf_next() == tasks[0]);
+	CHECK(sw_timer_edf_next() == NULL);
+
+	/* Completed in time */
+	sim_timer_run(50);
+
+	sw_timer_edf_complete(tasks[1]);
+	sw_timer_edf_complete(tasks[2]);
+	sw_timer_edf_complete(tasks[0]);
+
+	CHECK(sw_timer_edf_misses(NULL) == 0);
+
+	/* Released at once with no timer running, completed late */
+	sw_timer_edf_release_after(tasks[1], 0);
+
+	task = sw_timer_edf_next();
+
+	CHECK(task == tasks[1]);
+
+	sw_timer_edf_run(task);
+	sim_timer_run(150);
+	sw_timer_edf_complete(task);
+
+	CHECK(sw_timer_edf_misses(tasks[1]) == 1);
+	CHECK(sw_timer_edf_misses(NULL) == 1);
+
+	/* The next job completes in time */
+	sw_timer_edf_release_after(tasks[1], 20);
+	sim_timer_run(20);
+
+	task = sw_timer_edf_next();
+
+	CHECK(task == tasks[1]);
+
+	sim_timer_run(99);
+	sw_timer_edf_complete(task);
+
+	CHECK(sw_timer_edf_misses(tasks[1]) == 1);
+
+	/* The ready queue holds every task, tasks beyond it are not created */
+	for (i = 3; i < SW_TIMER_EDF_TASKS; i++) {
+		tasks[i] = sw_timer_edf_create(NULL, NULL, 1000 - i, &buffers[i]);
+
+		CHECK(tasks[i] != NULL);
+	}
+
+	CHECK(sw_timer_edf_create((sw_timer_func_ptr_t) job, NULL, 100, &buffers[SW_TIMER_EDF_TASKS]) == NULL);
+
+	for (i = 0; i < SW_TIMER_EDF_TASKS; i++)
+		sw_timer_edf_release_after(tasks[i], 5);
+
+	sim_timer_run(5);
+
+	CHECK(sw_timer_edf_next() == tasks[1]);
+	CHECK(sw_timer_edf_next() == tasks[2]);
+	CHECK(sw_timer_edf_next() == tasks[0]);
+
+	for (i = SW_TIMER_EDF_TASKS - 1; i >= 3; i--) {
+		task = sw_timer_edf_next();
+
+		CHECK(task == tasks[i]);
+
+		/* Tasks without a function can be run */
+		sw_timer_edf_run(task);
+		sw_timer_edf_complete(task);
+	}
+
+	CHECK(sw_timer_edf_next() == NULL);
+
+	sw_timer_edf_complete(tasks[0]);
+	sw_timer_edf_complete(tasks[1]);
+	sw_timer_edf_complete(tasks[2]);
+
+	/* Nothing is outstanding, no timer is left running */
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("edf");
+}
@@ -0,0 +1,155 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Engine cross-check fuzz.
+ *
+ * Random starts, stops, updates, reschedules and conditional arming are
+ * applied to the engine selected by SW_TIMER_ENGINE and to a model keeping
+ * the expected expiry of every timer. Every expiry and sampled remaining
+ * times are checked against the model, first with short delays tick by
+ * tick, then with long delays jumping from interrupt to interrupt. The
+ * printed trace digest does not depend on the engine, so the digests of
+ * all engines must be equal.
+ */
+
+#define TIMERS 200
+
+#define SHORT_STEPS 300000
+
+#define LONG_STEPS 100000
+
+static sw_timer_buffer_t buffers[TIMERS];
+
+static sw_timer_handle_t timers[TIMERS];
+
+// Expected expiry of every timer, -1 if it is not running
+static int64_t expected[TIMERS];
+
+static uint32_t periods[TIMERS];
+
+static sw_timer_mode_t modes[TIMERS];
+
+static uint64_t digest = 0;
+
+static uint32_t fired = 0;
+
+static uint32_t random_delay(uint32_t max)
+{
+	return 1 + (uint32_t) (((uint64_t) rand() * RAND_MAX + rand()) % max);
+}
+
+static void expired(void *arg)
+{
+	uint32_t i = (uint32_t) (uintptr_t) arg;
+	uint64_t trace = ((uint64_t) i << 40) ^ sim_clock;
+
+	CHECK((int64_t) sim_clock == expected[i]);
+
+	/* Order independent digest, timers due at the same time can expire in
+	 * any order */
+	trace *= 0x9e3779b97f4a7c15ull;
+	digest += trace ^ (trace >> 29);
+	fired++;
+
+	if (modes[i] == SW_TIMER_MODE_REPEATING)
+		expected[i] += periods[i];
+	else
+		expected[i] = -1;
+}
+
+static void step(uint32_t max_delay)
+{
+	uint32_t i = (uint32_t) rand() % TIMERS;
+	uint32_t delay = random_delay(max_delay);
+	int64_t time = (int64_t) sim_clock + delay;
+
+	switch (rand() % 8) {
+	case 0:
+	case 1:
+	case 2:
+		sw_timer_start(timers[i]);
+		expected[i] = (int64_t) sim_clock + periods[i];
+		break;
+	case 3:
+		sw_timer_stop(timers[i]);
+		expected[i] = -1;
+		break;
+	case 4:
+		sw_timer_update(timers[i], periods[i], modes[i], (sw_timer_func_ptr_t) expired, (void *) (uintptr_t) i);
+
+		if (expected[i] >= 0)
+			expected[i] = (int64_t) sim_clock + periods[i];
+		break;
+	case 5:
+		sw_timer_reschedule(timers[i], delay);
+		expected[i] = time;
+		break;
+	case 6:
+		sw_timer_arm_if_not_running(timers[i], delay);
+
+		if (expected[i] < 0)
+			expected[i] = time;
+		break;
+	default:
+		sw_timer_arm_if_earlier(timers[i], delay);
+
+		if ((expected[i] < 0) || (time < expected[i]))
+			expected[i] = time;
+		break;
+	}
+
+	i = (uint32_t) rand() % TIMERS;
+
+	if (expected[i] >= 0)
+		CHECK((int64_t) sim_clock + sw_timer_remaining(timers[i]) == expected[i]);
+	else
+		CHECK(sw_timer_remaining(timers[i]) == 0);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t i;
+	uint32_t n;
+
+	srand((argc > 1) ? (unsigned) atoi(argv[1]) : 1);
+
+	sim_timer_init();
+
+	for (i = 0; i < TIMERS; i++) {
+		static const uint32_t base_periods[5] = { 5, 17, 40, 100, 1000 };
+
+		periods[i] = base_periods[i % 5] + ((i % 7 == 0) ? i : 0);
+		modes[i] = (i % 3 != 0) ? SW_TIMER_MODE_REPEATING : SW_TIMER_MODE_SINGLE_SHOT;
+		expected[i] = -1;
+
+		timers[i] = sw_timer_create(periods[i], modes[i], (sw_timer_func_ptr_t) expired, (void *) (uintptr_t) i, &buffers[i]);
+	}
+
+	for (n = 0; n < SHORT_STEPS; n++) {
+		if (rand() % 4 == 0)
+			step(2000);
+
+		sim_timer_tick();
+	}
+
+	/* Long delays cross the half of the time range, the epoch moves */
+	for (n = 0; n < LONG_STEPS; n++) {
+		if (rand() % 2 == 0)
+			step(0x10000000);
+
+		if (rand() % 2 == 0)
+			sim_timer_jump();
+		else
+			sim_timer_tick();
+	}
+
+	for (i = 0; i < TIMERS; i++)
+		sw_timer_stop(timers[i]);
+
+	printf("engine %d: fired %u\n", SW_TIMER_ENGINE, fired);
+	printf("trace %016llx\n", (unsigned long long) digest);
+
+	return sim_timer_result("engine");
+}
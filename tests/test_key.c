@@ -0,0 +1,125 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Key index behavior test.
+ *
+ * Random binds and unbinds are checked against a model keeping the timer
+ * bound to every key. The index is kept almost full, so probe sequences are
+ * long and unbinding shifts entries back over wrapped clusters; every key
+ * must still be found after each change. Keyed rescheduling and stopping
+ * reach the bound timer.
+ */
+
+#define KEYS 200
+
+#define TIMERS 8
+
+#define STEPS 100000
+
+static sw_timer_buffer_t buffers[TIMERS];
+
+static sw_timer_handle_t timers[TIMERS];
+
+// Timer bound to every key of the model, NULL if the key is not bound
+static sw_timer_handle_t bound[KEYS];
+
+static uint32_t fired = 0;
+
+static void expired(void *arg)
+{
+	(void) arg;
+
+	fired++;
+}
+
+/**
+ * @brief Returns key of the model index, session ids and kinds are packed
+ * to different bit fields.
+ */
+static uint64_t key_of(uint32_t i)
+{
+	return ((uint64_t) (i / 4) << 32) | (i % 4);
+}
+
+static void check_all(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < KEYS; i++)
+		CHECK(sw_timer_key_find(key_of(i)) == bound[i]);
+}
+
+int main(void)
+{
+	uint32_t count = 0;
+	uint32_t full = 0;
+	uint32_t i;
+	uint32_t n;
+
+	srand(11);
+
+	sim_timer_init();
+
+	for (i = 0; i < TIMERS; i++)
+		timers[i] = sw_timer_create(10, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) expired, NULL, &buffers[i]);
+
+	CHECK(sw_timer_key_bind(key_of(0), NULL) == SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST);
+
+	for (n = 0; n < STEPS; n++) {
+		sw_timer_handle_t timer = timers[(uint32_t) rand() % TIMERS];
+		sw_timer_status_t status;
+
+		i = (uint32_t) rand() % KEYS;
+
+		/* Binds are more frequent, so the index stays almost full */
+		if (rand() % 8 < 5) {
+			status = sw_timer_key_bind(key_of(i), timer);
+
+			if ((bound[i] == NULL) && (count >= SW_TIMER_KEY_SLOTS - 1)) {
+				CHECK(status == SW_TIMER_STATUS_ERROR_KEY_INDEX_FULL);
+				full++;
+			} else {
+				CHECK(status == SW_TIMER_STATUS_OK);
+				count += (bound[i] == NULL) ? 1 : 0;
+				bound[i] = timer;
+			}
+		} else {
+			status = sw_timer_key_unbind(key_of(i));
+
+			CHECK((status == SW_TIMER_STATUS_OK) == (bound[i] != NULL));
+			count -= (bound[i] != NULL) ? 1 : 0;
+			bound[i] = NULL;
+		}
+
+		check_all();
+	}
+
+	CHECK(full > 0);
+
+	/* Keyed calls reach the bound timer */
+	for (i = 0; (i < KEYS) && (bound[i] == NULL); i++)
+		;
+
+	CHECK(i < KEYS);
+
+	CHECK(sw_timer_key_reschedule(key_of(i), 10) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_remaining(bound[i]) == 10);
+	CHECK(sw_timer_key_stop(key_of(i)) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_remaining(bound[i]) == 0);
+
+	CHECK(sw_timer_key_reschedule(key_of(i), 10) == SW_TIMER_STATUS_OK);
+	sim_timer_run(10);
+
+	CHECK(fired == 1);
+
+	/* Unbound keys are reported */
+	CHECK(sw_timer_key_unbind(key_of(i)) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_key_unbind(key_of(i)) == SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST);
+	CHECK(sw_timer_key_reschedule(key_of(i), 10) == SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST);
+	CHECK(sw_timer_key_stop(key_of(i)) == SW_TIMER_STATUS_ERROR_KEY_NOT_EXIST);
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("key");
+}
@@ -0,0 +1,127 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Lease manager behavior test.
+ *
+ * Leases are granted with random durations. The renewal of a lease comes
+ * in the granularity interval before its renewal time, a renewed lease
+ * does not expire, and a lease that is not renewed expires in the
+ * granularity interval after its expiry. Released leases get no callback.
+ */
+
+#define LEASES 500
+
+#define STEPS 1000000
+
+#define STATE_IDLE 0
+
+#define STATE_GRANTED 1
+
+#define STATE_RENEW_DELIVERED 2
+
+static sw_timer_lease_buffer_t buffers[LEASES];
+
+static sw_timer_lease_handle_t leases[LEASES];
+
+static int64_t renew_times[LEASES];
+
+static int64_t expiries[LEASES];
+
+static uint32_t states[LEASES];
+
+static uint32_t renewals = 0;
+
+static uint32_t expired_leases = 0;
+
+static void grant(uint32_t i)
+{
+	uint32_t duration = 1 + (uint32_t) rand() % 3000;
+	uint32_t renew_ahead = (uint32_t) rand() % 500;
+
+	CHECK(sw_timer_lease_grant(leases[i], duration, renew_ahead) == SW_TIMER_STATUS_OK);
+
+	expiries[i] = (int64_t) sim_clock + duration;
+	renew_times[i] = (renew_ahead < duration) ? (expiries[i] - renew_ahead) : ((int64_t) sim_clock + 1);
+	states[i] = STATE_GRANTED;
+}
+
+static void renew(sw_timer_lease_handle_t *handles, uint32_t count)
+{
+	uint32_t k;
+
+	for (k = 0; k < count; k++) {
+		uint32_t i = (uint32_t) (uintptr_t) sw_timer_lease_arg(handles[k]);
+
+		CHECK(states[i] == STATE_GRANTED);
+		CHECK((int64_t) sim_clock <= renew_times[i]);
+		CHECK((int64_t) sim_clock + SW_TIMER_LEASE_GRANULARITY >= renew_times[i]);
+
+		states[i] = STATE_RENEW_DELIVERED;
+		renewals++;
+
+		/* Every other renewal is granted, the others expire */
+		if (rand() % 2 == 0)
+			grant(i);
+	}
+}
+
+static void expire(sw_timer_lease_handle_t *handles, uint32_t count)
+{
+	uint32_t k;
+
+	for (k = 0; k < count; k++) {
+		uint32_t i = (uint32_t) (uintptr_t) sw_timer_lease_arg(handles[k]);
+
+		CHECK(states[i] == STATE_RENEW_DELIVERED);
+		CHECK((int64_t) sim_clock >= expiries[i]);
+		CHECK((int64_t) sim_clock <= expiries[i] + SW_TIMER_LEASE_GRANULARITY);
+
+		states[i] = STATE_IDLE;
+		expired_leases++;
+	}
+}
+
+int main(void)
+{
+	uint32_t i;
+	uint32_t n;
+
+	srand(5);
+
+	sim_timer_init();
+	sw_timer_lease_register_callbacks(renew, expire);
+
+	for (i = 0; i < LEASES; i++)
+		leases[i] = sw_timer_lease_create((void *) (uintptr_t) i, &buffers[i]);
+
+	for (n = 0; n < STEPS; n++) {
+		i = (uint32_t) rand() % LEASES;
+
+		switch (rand() % 200) {
+		case 0:
+			grant(i);
+			break;
+		case 1:
+			CHECK(sw_timer_lease_release(leases[i]) == SW_TIMER_STATUS_OK);
+			states[i] = STATE_IDLE;
+			break;
+		default:
+			break;
+		}
+
+		sim_timer_tick();
+	}
+
+	CHECK(renewals > 0);
+	CHECK(expired_leases > 0);
+
+	/* The wakeup timer stops with the last lease */
+	for (i = 0; i < LEASES; i++)
+		sw_timer_lease_release(leases[i]);
+
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("lease");
+}
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Timer pool behavior test.
+ *
+ * Random creates and releases are checked against a model of allocated
+ * slots. The pool hands out every slot once before it is full, an id is
+ * stale after its release even when the slot is reused, and stale ids
+ * neither find nor stop the timer that reuses the slot. Released timers
+ * never expire.
+ */
+
+#define STEPS 200000
+
+#define STALE_IDS 64
+
+// Ids of allocated timers of the model, SW_TIMER_ID_NONE if the entry is free
+static sw_timer_id_t ids[SW_TIMER_POOL_SIZE];
+
+// Expected expiry of every model timer, -1 if it is not running
+static int64_t expected[SW_TIMER_POOL_SIZE];
+
+// Released ids, overwritten in round robin
+static sw_timer_id_t stale_ids[STALE_IDS];
+
+static uint32_t fired = 0;
+
+static uint32_t full = 0;
+
+static void expired(void *arg)
+{
+	uint32_t i = (uint32_t) (uintptr_t) arg;
+
+	CHECK(ids[i] != SW_TIMER_ID_NONE);
+	CHECK(expected[i] == (int64_t) sim_clock);
+
+	expected[i] = -1;
+	fired++;
+}
+
+/**
+ * @brief Returns free model entry, SW_TIMER_POOL_SIZE if the pool is full.
+ */
+static uint32_t free_entry(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < SW_TIMER_POOL_SIZE; i++)
+		if (ids[i] == SW_TIMER_ID_NONE)
+			break;
+
+	return i;
+}
+
+int main(void)
+{
+	uint32_t stale_next = 0;
+	uint32_t created = 0;
+	uint32_t i;
+	uint32_t n;
+
+	srand(7);
+
+	sim_timer_init();
+
+	for (i = 0; i < SW_TIMER_POOL_SIZE; i++)
+		expected[i] = -1;
+
+	for (n = 0; n < STEPS; n++) {
+		sw_timer_id_t id;
+		uint32_t delay = 1 + (uint32_t) rand() % 100;
+
+		i = (uint32_t) rand() % SW_TIMER_POOL_SIZE;
+
+		switch (rand() % 8) {
+		case 0:
+			i = free_entry();
+			id = sw_timer_pool_create(delay, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) expired,
+					(void *) (uintptr_t) i);
+
+			if (i == SW_TIMER_POOL_SIZE) {
+				CHECK(id == SW_TIMER_ID_NONE);
+				full++;
+				break;
+			}
+
+			CHECK(id != SW_TIMER_ID_NONE);
+			CHECK(sw_timer_pool_get(id) != NULL);
+
+			ids[i] = id;
+			created++;
+			break;
+		case 1:
+			if (ids[i] == SW_TIMER_ID_NONE)
+				break;
+
+			CHECK(sw_timer_pool_release(ids[i]) == SW_TIMER_STATUS_OK);
+
+			stale_ids[stale_next++ % STALE_IDS] = ids[i];
+			ids[i] = SW_TIMER_ID_NONE;
+			expected[i] = -1;
+			break;
+		case 2:
+		case 3:
+			if (ids[i] == SW_TIMER_ID_NONE)
+				break;
+
+			CHECK(sw_timer_reschedule(sw_timer_pool_get(ids[i]), delay) == SW_TIMER_STATUS_OK);
+
+			expected[i] = (int64_t) sim_clock + delay;
+			break;
+		case 4:
+			if (ids[i] == SW_TIMER_ID_NONE)
+				break;
+
+			sw_timer_pool_stop(ids[i]);
+
+			expected[i] = -1;
+			break;
+		default:
+			break;
+		}
+
+		/* Stale ids are rejected without touching the slot */
+		id = stale_ids[(uint32_t) rand() % STALE_IDS];
+
+		if (id != SW_TIMER_ID_NONE) {
+			CHECK(sw_timer_pool_get(id) == NULL);
+			CHECK(sw_timer_pool_stop(id) == SW_TIMER_STATUS_ERROR_TIMER_STALE);
+			CHECK(sw_timer_pool_release(id) == SW_TIMER_STATUS_ERROR_TIMER_STALE);
+		}
+
+		sim_timer_tick();
+	}
+
+	CHECK(created > SW_TIMER_POOL_SIZE);
+	CHECK(fired > 0);
+	CHECK(full > 0);
+	CHECK(sw_timer_pool_get(SW_TIMER_ID_NONE) == NULL);
+
+	/* The physical timer stops with the last released timer */
+	for (i = 0; i < SW_TIMER_POOL_SIZE; i++)
+		if (ids[i] != SW_TIMER_ID_NONE)
+			CHECK(sw_timer_pool_release(ids[i]) == SW_TIMER_STATUS_OK);
+
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("pool");
+}
@@ -0,0 +1,124 @@
+#include "sim_timer.h"
+
+/**
+ * @brief Expiry ring behavior test.
+ *
+ * Expiries of ring timers are pushed to the ring in expiry order instead of
+ * calling their callbacks. When the ring is full, further expiries are
+ * dropped and counted in ring_dropped, and popping makes room again. Timers
+ * without ring delivery keep their callbacks.
+ */
+
+#define TIMERS (SW_TIMER_RING_SIZE + 4)
+
+static sw_timer_buffer_t buffers[TIMERS];
+
+static sw_timer_handle_t timers[TIMERS];
+
+static uint32_t called = 0;
+
+static void expired(void *arg)
+{
+	(void) arg;
+
+	called++;
+}
+
+int main(void)
+{
+	static sw_timer_buffer_t plain_buffer;
+	sw_timer_expiry_t records[TIMERS];
+	sw_timer_stats_t stats;
+	sw_timer_handle_t plain;
+	uint32_t start;
+	uint32_t count;
+	uint32_t i;
+
+	sim_timer_init();
+
+	for (i = 0; i < TIMERS; i++) {
+		timers[i] = sw_timer_create(10 + i / 2, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) expired,
+				(void *) (uintptr_t) i, &buffers[i]);
+
+		CHECK(sw_timer_ring_delivery(timers[i], 1) == SW_TIMER_STATUS_OK);
+	}
+
+	plain = sw_timer_create(10, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) expired, NULL, &plain_buffer);
+
+	/* More expiries than records, the ring keeps the first ones */
+	start = sw_timer_now();
+
+	for (i = 0; i < TIMERS; i++)
+		sw_timer_start(timers[i]);
+
+	sw_timer_start(plain);
+	sim_timer_run(10 + TIMERS / 2);
+
+	CHECK(called == 1);
+
+	sw_timer_get_stats(&stats);
+
+	CHECK(stats.ring_dropped == TIMERS - SW_TIMER_RING_SIZE);
+	CHECK(stats.ring_max_used == SW_TIMER_RING_SIZE);
+
+	count = sw_timer_ring_pop(records, 3);
+	count += sw_timer_ring_pop(&records[count], TIMERS);
+
+	CHECK(count == SW_TIMER_RING_SIZE);
+
+	for (i = 0; i < count; i++) {
+		CHECK(records[i].timer == timers[i]);
+		CHECK(records[i].arg == (void *) (uintptr_t) i);
+		CHECK(records[i].deadline == start + 10 + i / 2);
+		CHECK(records[i].time == records[i].deadline);
+	}
+
+	CHECK(sw_timer_ring_pop(records, TIMERS) == 0);
+
+	/* Popped records make room for new expiries */
+	sw_timer_start(timers[TIMERS - 1]);
+	sim_timer_run(10 + TIMERS / 2);
+
+	CHECK(sw_timer_ring_pop(records, TIMERS) == 1);
+	CHECK(records[0].timer == timers[TIMERS - 1]);
+
+	sw_timer_get_stats(&stats);
+
+	CHECK(stats.ring_dropped == TIMERS - SW_TIMER_RING_SIZE);
+
+	/* A repeating timer popped in time drops nothing */
+	sw_timer_update(timers[0], 3, SW_TIMER_MODE_REPEATING, (sw_timer_func_ptr_t) expired, NULL);
+	sw_timer_start(timers[0]);
+
+	start = sw_timer_now();
+
+	for (i = 1; i <= 1000; i++) {
+		sim_timer_tick();
+
+		count = sw_timer_ring_pop(records, TIMERS);
+
+		CHECK(count == ((i % 3 == 0) ? 1 : 0));
+
+		if (count != 0)
+			CHECK(records[0].deadline == start + i);
+	}
+
+	sw_timer_get_stats(&stats);
+
+	CHECK(stats.ring_dropped == TIMERS - SW_TIMER_RING_SIZE);
+
+	/* Without ring delivery the callback is called again */
+	CHECK(sw_timer_ring_delivery(timers[0], 0) == SW_TIMER_STATUS_OK);
+
+	called = 0;
+	sim_timer_run(3);
+
+	CHECK(called == 1);
+	CHECK(sw_timer_ring_pop(records, TIMERS) == 0);
+
+	sw_timer_stop(timers[0]);
+
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("ring");
+}
@@ -0,0 +1,132 @@
+#include "sim_timer.h"
+
+/**
+ * @brief Tick mode behavior test.
+ *
+ * A repeating timer programs the physical timer at every expiry, so its
+ * period sets the programming rate. A fast timer enters the tick mode, a
+ * rate between SW_TIMER_TICK_LEAVE and SW_TIMER_TICK_ENTER keeps the current
+ * mode either way and a slow timer leaves the tick mode. Expiries are handled
+ * exactly in time in the tickless mode and at most one tick period late in
+ * the tick mode.
+ */
+
+// Windows every rate is kept for, the mode is switched after the first one
+#define WINDOWS 20
+
+#define WINDOW_TICKS (SW_TIMER_TICK_PERIOD * SW_TIMER_TICK_WINDOW)
+
+// Periods of the fast, moderate and slow timer
+#define FAST 1
+
+#define MODERATE 3
+
+#define SLOW 16
+
+static sw_timer_buffer_t buffer;
+
+static sw_timer_handle_t timer;
+
+// Nominal time of the next expiry
+static uint64_t nominal;
+
+static uint32_t period;
+
+static uint32_t started = 0;
+
+static uint32_t fired = 0;
+
+static uint64_t max_late = 0;
+
+static void expired(void *arg)
+{
+	(void) arg;
+
+	CHECK(sim_clock >= nominal);
+
+	if (sim_clock - nominal > max_late)
+		max_late = sim_clock - nominal;
+
+	nominal += period;
+	fired++;
+}
+
+/**
+ * @brief Restarts the timer with the period and runs the windows, returns
+ * number of mode switches during them.
+ */
+static uint32_t run(uint32_t new_period, uint32_t windows)
+{
+	sw_timer_stats_t stats;
+	uint32_t switches;
+
+	sw_timer_get_stats(&stats);
+	switches = stats.tick_switches;
+
+	period = new_period;
+	nominal = sim_clock + period;
+	max_late = 0;
+
+	/* A running timer is rescheduled without stopping, which would leave the
+	 * tick mode */
+	sw_timer_update(timer, period, SW_TIMER_MODE_REPEATING, (sw_timer_func_ptr_t) expired, NULL);
+
+	if (!started)
+		sw_timer_start(timer);
+
+	started = 1;
+
+	sim_timer_run(windows * WINDOW_TICKS);
+
+	sw_timer_get_stats(&stats);
+
+	return stats.tick_switches - switches;
+}
+
+int main(void)
+{
+	sw_timer_stats_t stats;
+
+	sim_timer_init();
+
+	timer = sw_timer_create(FAST, SW_TIMER_MODE_REPEATING, (sw_timer_func_ptr_t) expired, NULL, &buffer);
+
+	/* A moderate rate does not enter the tick mode */
+	CHECK(run(MODERATE, WINDOWS) == 0);
+	CHECK(max_late == 0);
+
+	/* A fast rate enters it, expiries are up to a tick period late */
+	CHECK(run(FAST, WINDOWS) == 1);
+	CHECK(max_late > 0);
+	CHECK(max_late <= SW_TIMER_TICK_PERIOD);
+
+	/* The physical timer only ticks in the tick mode */
+	CHECK(sim_remaining <= SW_TIMER_TICK_PERIOD);
+
+	/* A moderate rate does not leave it */
+	CHECK(run(MODERATE, WINDOWS) == 0);
+	CHECK(max_late > 0);
+	CHECK(max_late <= SW_TIMER_TICK_PERIOD);
+
+	/* A slow rate leaves it after the window in progress and a whole one,
+	 * expiries are in time again */
+	CHECK(run(SLOW, 2) == 1);
+	CHECK(max_late <= SW_TIMER_TICK_PERIOD);
+	CHECK(run(SLOW, WINDOWS) == 0);
+	CHECK(max_late == 0);
+
+	/* The tick mode is left when the last timer stops */
+	CHECK(run(FAST, WINDOWS) == 1);
+
+	sw_timer_stop(timer);
+
+	sw_timer_get_stats(&stats);
+
+	CHECK(stats.tick_switches == 4);
+	CHECK(stats.tick_time >= (WINDOWS * 2 - 2) * WINDOW_TICKS);
+	CHECK(stats.tickless_time >= (WINDOWS * 2 - 2) * WINDOW_TICKS);
+	CHECK(fired > 0);
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("tick");
+}
@@ -0,0 +1,139 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief TTL map behavior test.
+ *
+ * Random puts, removes and gets are checked against a model. An entry is
+ * found until its expiry, evicted once not earlier than its expiry and not
+ * later than one wheel resolution after it, and removed entries are never
+ * evicted. The same holds while the map time wraps, the resolution does not
+ * divide 2^32, so the wheel slots are not aligned to the wrap.
+ */
+
+#define ENTRIES 1000
+
+#define STEPS 1000000
+
+// Longest TTL, several wheel turns
+#define TTL_MAX 40000
+
+// Map time of the wrap run, it crosses the wrap once at least
+#define WRAP_TIME (0x100000000ull + TTL_MAX)
+
+static sw_timer_ttl_entry_buffer_t buffers[ENTRIES];
+
+// An entry keeping the map running, it is never evicted
+static sw_timer_ttl_entry_buffer_t keeper;
+
+// Expiry of every entry in the map, -1 if it is not in the map
+static int64_t expiries[ENTRIES];
+
+static uint32_t evicted = 0;
+
+static void evict(uint64_t key, void *value)
+{
+	CHECK(key < ENTRIES);
+	CHECK(value == &buffers[key]);
+	CHECK(expiries[key] >= 0);
+	CHECK((int64_t) sim_clock >= expiries[key]);
+	CHECK((int64_t) sim_clock <= expiries[key] + SW_TIMER_TTL_RESOLUTION);
+
+	expiries[key] = -1;
+	evicted++;
+}
+
+int main(void)
+{
+	uint64_t start;
+	uint64_t renewed;
+	uint32_t count = 0;
+	uint32_t i;
+	uint32_t n;
+
+	srand(3);
+
+	sim_timer_init();
+	sw_timer_ttl_register_evict_callback(evict);
+
+	for (i = 0; i < ENTRIES; i++)
+		expiries[i] = -1;
+
+	for (n = 0; n < STEPS; n++) {
+		uint32_t key = (uint32_t) rand() % ENTRIES;
+		uint32_t ttl = 1 + (uint32_t) rand() % TTL_MAX;
+		void *value;
+
+		switch (rand() % 50) {
+		case 0:
+			CHECK(sw_timer_ttl_put(key, &buffers[key], ttl, &buffers[key]) == SW_TIMER_STATUS_OK);
+			expiries[key] = (int64_t) sim_clock + ttl;
+			break;
+		case 1:
+			CHECK((sw_timer_ttl_remove(key) == SW_TIMER_STATUS_OK) == (expiries[key] >= 0));
+			expiries[key] = -1;
+			break;
+		case 2:
+			value = sw_timer_ttl_get(key);
+
+			if ((expiries[key] >= 0) && ((int64_t) sim_clock < expiries[key]))
+				CHECK(value == &buffers[key]);
+			else
+				CHECK(value == NULL);
+			break;
+		default:
+			break;
+		}
+
+		sim_timer_tick();
+	}
+
+	for (i = 0; i < ENTRIES; i++)
+		count += (expiries[i] >= 0) ? 1 : 0;
+
+	CHECK(evicted > 0);
+	CHECK(sw_timer_ttl_count() == count);
+
+	/* The wheel stops with the last entry */
+	for (i = 0; i < ENTRIES; i++)
+		sw_timer_ttl_remove(i);
+
+	CHECK(sw_timer_ttl_count() == 0);
+	CHECK(sim_remaining == 0);
+
+	/* The map time wraps while the map is not empty, the time jumps from
+	 * one wheel step to the next */
+	start = sim_clock;
+	renewed = sim_clock;
+	evicted = 0;
+
+	sw_timer_ttl_put(ENTRIES, &keeper, 0x7fffffff, &keeper);
+
+	while (sim_clock - start < WRAP_TIME) {
+		uint32_t key = (uint32_t) rand() % ENTRIES;
+		uint32_t ttl = 1 + (uint32_t) rand() % TTL_MAX;
+
+		if (rand() % 16 == 0) {
+			CHECK(sw_timer_ttl_put(key, &buffers[key], ttl, &buffers[key]) == SW_TIMER_STATUS_OK);
+			expiries[key] = (int64_t) sim_clock + ttl;
+		}
+
+		if (sim_clock - renewed > 0x40000000) {
+			sw_timer_ttl_put(ENTRIES, &keeper, 0x7fffffff, &keeper);
+			renewed = sim_clock;
+		}
+
+		sim_timer_jump();
+	}
+
+	CHECK(evicted > 0);
+
+	for (i = 0; i <= ENTRIES; i++)
+		sw_timer_ttl_remove(i);
+
+	CHECK(sw_timer_ttl_count() == 0);
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("ttl");
+}
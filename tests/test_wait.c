@@ -0,0 +1,164 @@
+#include "sim_timer.h"
+
+/**
+ * @brief Blocking wait behavior test.
+ *
+ * The wait callback runs the simulated time until the interrupt handler
+ * wakes the word it waits on. Waits return at the expiry of their timer or
+ * with an error when it is stopped, a group wait returns the index of the
+ * first expired timer, and only expiries of waited timers wake anybody.
+ */
+
+static sw_timer_buffer_t buffers[4];
+
+static sw_timer_handle_t timers[4];
+
+// A word the simulated thread waits on, NULL if it does not wait
+static volatile uint32_t *waited_word = NULL;
+
+static uint32_t woken = 0;
+
+static uint32_t wakes = 0;
+
+static uint32_t waits = 0;
+
+// A word group waits wait on, NULL until the first group wait
+static volatile uint32_t *group_word = NULL;
+
+static uint32_t group_wakes = 0;
+
+static void wake(volatile uint32_t *word)
+{
+	wakes++;
+
+	if (word == group_word)
+		group_wakes++;
+
+	if (word == waited_word)
+		woken = 1;
+}
+
+static void wait(volatile uint32_t *word, uint32_t value)
+{
+	waits++;
+
+	CHECK(*word == value);
+
+	waited_word = word;
+	woken = 0;
+
+	while (!woken && (sim_remaining != 0))
+		sim_timer_tick();
+
+	/* The wait would block forever */
+	CHECK(woken);
+
+	waited_word = NULL;
+}
+
+static void group_wait(volatile uint32_t *word, uint32_t value)
+{
+	group_word = word;
+
+	wait(word, value);
+}
+
+static void stop_first(void *arg)
+{
+	(void) arg;
+
+	sw_timer_stop(timers[0]);
+}
+
+int main(void)
+{
+	uint32_t expiries[3];
+	uint32_t index = 3;
+	uint32_t i;
+
+	sim_timer_init();
+	sw_timer_register_wait_callbacks(wait, wake);
+
+	for (i = 0; i < 4; i++)
+		timers[i] = sw_timer_create(10 * (i + 1), SW_TIMER_MODE_SINGLE_SHOT, NULL, NULL, &buffers[i]);
+
+	/* A wait returns at the expiry, other expiries wake nobody */
+	expiries[0] = sw_timer_expiries(timers[0]);
+
+	sw_timer_start(timers[1]);
+	sw_timer_start(timers[0]);
+	sim_timer_run(5);
+
+	CHECK(sw_timer_wait(timers[0], expiries[0]) == SW_TIMER_STATUS_OK);
+	CHECK(sim_clock == 10);
+	CHECK(wakes == 1);
+
+	sim_timer_run(10);
+
+	CHECK(wakes == 1);
+
+	/* An expiry that was already counted returns without waiting */
+	waits = 0;
+
+	CHECK(sw_timer_wait(timers[0], expiries[0]) == SW_TIMER_STATUS_OK);
+	CHECK(waits == 0);
+
+	/* Stopped timers wake their waiters with an error */
+	sw_timer_update(timers[3], 5, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) stop_first, NULL);
+
+	expiries[0] = sw_timer_expiries(timers[0]);
+
+	sw_timer_start(timers[0]);
+	sw_timer_start(timers[3]);
+
+	wakes = 0;
+
+	CHECK(sw_timer_wait(timers[0], expiries[0]) == SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING);
+	CHECK(sim_clock == 25);
+	CHECK(wakes == 1);
+	CHECK(sw_timer_wait(timers[0], expiries[0]) == SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING);
+
+	/* A group wait returns the first expired timer */
+	for (i = 0; i < 3; i++)
+		expiries[i] = sw_timer_expiries(timers[i]);
+
+	sw_timer_update(timers[0], 30, SW_TIMER_MODE_SINGLE_SHOT, NULL, NULL);
+	sw_timer_update(timers[3], 5, SW_TIMER_MODE_SINGLE_SHOT, NULL, NULL);
+
+	sw_timer_start(timers[0]);
+	sw_timer_start(timers[1]);
+	sw_timer_start(timers[2]);
+	sw_timer_start(timers[3]);
+
+	wakes = 0;
+
+	sw_timer_register_wait_callbacks(group_wait, wake);
+
+	CHECK(sw_timer_wait_any(timers, expiries, 3, &index) == SW_TIMER_STATUS_OK);
+	CHECK(index == 1);
+	CHECK(sim_clock == 45);
+	CHECK(wakes == 1);
+
+	/* Marks of the other timers of the group are left, as other groups can
+	 * wait for them, but timers expiring together wake group waiters once */
+	group_wakes = 0;
+
+	sim_timer_run(20);
+
+	CHECK(group_wakes == 1);
+
+	/* A group of stopped timers returns an error */
+	for (i = 0; i < 3; i++)
+		expiries[i] = sw_timer_expiries(timers[i]);
+
+	sw_timer_start(timers[0]);
+	sw_timer_update(timers[3], 10, SW_TIMER_MODE_SINGLE_SHOT, (sw_timer_func_ptr_t) stop_first, NULL);
+	sw_timer_start(timers[3]);
+
+	CHECK(sw_timer_wait_any(timers, expiries, 3, &index) == SW_TIMER_STATUS_ERROR_TIMER_NOT_RUNNING);
+	CHECK(sim_clock == 75);
+
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("wait");
+}
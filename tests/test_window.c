@@ -0,0 +1,148 @@
+#include <stdlib.h>
+
+#include "sim_timer.h"
+
+/**
+ * @brief Sliding window counter behavior test.
+ *
+ * Random adds to counters of two widths are checked against a model keeping
+ * the value added in every bucket period. Counters are used at random, so
+ * their buckets are rotated lazily by one or several steps or all at once
+ * after long idle periods; sums of all and of the last buckets must match
+ * the model. Counters of one width share a clock, which is freed with the
+ * last of them.
+ */
+
+#define WINDOWS 3
+
+#define STEPS 100000
+
+// Bucket periods of the longest run, widths are at least 5 ticks
+#define PERIODS (STEPS / 5 + 2)
+
+static const uint32_t widths[WINDOWS] = { 10, 10, 7 };
+
+static const uint32_t lengths[WINDOWS] = { SW_TIMER_WINDOW_BUCKETS, 3, SW_TIMER_WINDOW_BUCKETS };
+
+static sw_timer_window_buffer_t buffers[WINDOWS];
+
+static sw_timer_window_handle_t windows[WINDOWS];
+
+// Time the clock of every counter was started at
+static uint64_t starts[WINDOWS];
+
+// Values added to every counter in every bucket period from the clock start
+static uint32_t added[WINDOWS][PERIODS];
+
+static uint32_t period_of(uint32_t w)
+{
+	return (uint32_t) ((sim_clock - starts[w]) / widths[w]);
+}
+
+/**
+ * @brief Returns model sum of the last buckets of the counter.
+ */
+static uint32_t model_sum(uint32_t w, uint32_t length)
+{
+	uint32_t period = period_of(w);
+	uint32_t sum = 0;
+	uint32_t i;
+
+	if (length > lengths[w])
+		length = lengths[w];
+
+	for (i = 0; (i < length) && (i <= period); i++)
+		sum += added[w][period - i];
+
+	return sum;
+}
+
+int main(void)
+{
+	static sw_timer_window_buffer_t buffer;
+	uint32_t length;
+	uint32_t w;
+	uint32_t n;
+
+	srand(17);
+
+	sim_timer_init();
+
+	CHECK(sw_timer_window_create(10, 0, &buffer) == NULL);
+	CHECK(sw_timer_window_create(10, SW_TIMER_WINDOW_BUCKETS + 1, &buffer) == NULL);
+	CHECK(sw_timer_window_create(0, 1, &buffer) == NULL);
+
+	for (w = 0; w < WINDOWS; w++) {
+		windows[w] = sw_timer_window_create(widths[w], lengths[w], &buffers[w]);
+
+		CHECK(windows[w] != NULL);
+
+		/* The second counter of width 10 joins the running clock */
+		starts[w] = (w == 1) ? starts[0] : sim_clock;
+
+		sim_timer_run(3);
+	}
+
+	/* Both clocks are taken */
+	CHECK(sw_timer_window_create(13, 1, &buffer) == NULL);
+
+	for (n = 0; n < STEPS; n++) {
+		uint32_t value = (uint32_t) rand() % 100;
+
+		w = (uint32_t) rand() % WINDOWS;
+
+		/* Counters are used rarely, so they are often rotated by several
+		 * steps and sometimes by more than their length */
+		switch (rand() % 64) {
+		case 0:
+			sw_timer_window_add(windows[w], value);
+			added[w][period_of(w)] += value;
+			break;
+		case 1:
+			CHECK(sw_timer_window_sum(windows[w]) == model_sum(w, lengths[w]));
+			break;
+		case 2:
+			for (length = 0; length <= lengths[w] + 1; length++)
+				CHECK(sw_timer_window_sum_last(windows[w], length) == model_sum(w, length));
+			break;
+		default:
+			break;
+		}
+
+		sim_timer_tick();
+	}
+
+	/* A deleted counter leaves the clock to the other counter of its width */
+	CHECK(sw_timer_window_delete(windows[0]) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_window_create(13, 1, &buffer) == NULL);
+
+	sim_timer_run(100);
+
+	CHECK(sw_timer_window_sum(windows[1]) == model_sum(1, lengths[1]));
+
+	/* The last counter of the width frees the clock */
+	CHECK(sw_timer_window_delete(windows[1]) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_window_delete(windows[1]) == SW_TIMER_STATUS_ERROR_TIMER_NOT_EXIST);
+
+	windows[0] = sw_timer_window_create(13, 2, &buffers[0]);
+
+	CHECK(windows[0] != NULL);
+
+	sw_timer_window_add(windows[0], 5);
+	sim_timer_run(13);
+	sw_timer_window_add(windows[0], 6);
+
+	CHECK(sw_timer_window_sum(windows[0]) == 11);
+	CHECK(sw_timer_window_sum_last(windows[0], 1) == 6);
+
+	sim_timer_run(13);
+
+	CHECK(sw_timer_window_sum(windows[0]) == 6);
+
+	/* Rotation timers stop with the last counters */
+	CHECK(sw_timer_window_delete(windows[0]) == SW_TIMER_STATUS_OK);
+	CHECK(sw_timer_window_delete(windows[2]) == SW_TIMER_STATUS_OK);
+	CHECK(sim_remaining == 0);
+
+	return sim_timer_result("window");
+}